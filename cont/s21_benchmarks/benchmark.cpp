@@ -0,0 +1,6 @@
+#include <benchmark/benchmark.h>
+
+#include "../s21_containers.h"
+#include "../s21_containersplus.h"
+
+BENCHMARK_MAIN();
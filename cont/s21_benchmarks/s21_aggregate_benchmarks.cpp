@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include "../s21_library/s21_map.h"
+
+// Сумма значений по окну ключей: проход по окну (for_each_in_range)
+// против aggregate на дереве с range_sum. Аргументы: число ключей и
+// ширина окна.
+
+using plain_map = s21::map<int, int64_t>;
+using sum_map = s21::map<int, int64_t, std::less<int>,
+                         std::allocator<std::pair<int, int64_t>>,
+                         s21::range_sum<int64_t>>;
+
+template <typename map_type>
+static map_type build(size_t count) {
+  map_type tree;
+  std::mt19937 rng(5);
+  for (size_t i = 0; i < count; ++i) {
+    tree.insert_or_assign(static_cast<int>(rng() % (count * 4)),
+                          static_cast<int64_t>(rng() % 1000));
+  }
+  return tree;
+}
+
+static void bm_window_scan(benchmark::State& state) {
+  size_t count = state.range(0);
+  int width = static_cast<int>(state.range(1));
+  const plain_map tree = build<plain_map>(count);
+  std::mt19937 rng(8);
+  int64_t total = 0;
+  for (auto _ : state) {
+    int lo = static_cast<int>(rng() % (count * 4));
+    tree.for_each_in_range(lo, lo + width, [&total](const auto& item) {
+      total += item.second;
+    });
+  }
+  benchmark::DoNotOptimize(total);
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void bm_window_aggregate(benchmark::State& state) {
+  size_t count = state.range(0);
+  int width = static_cast<int>(state.range(1));
+  const sum_map tree = build<sum_map>(count);
+  std::mt19937 rng(8);
+  int64_t total = 0;
+  for (auto _ : state) {
+    int lo = static_cast<int>(rng() % (count * 4));
+    total += tree.aggregate(lo, lo + width);
+  }
+  benchmark::DoNotOptimize(total);
+  state.SetItemsProcessed(state.iterations());
+}
+
+// цена поддержки агрегата при записи
+template <typename map_type>
+static void bm_assign(benchmark::State& state) {
+  size_t count = state.range(0);
+  map_type tree = build<map_type>(count);
+  std::mt19937 rng(8);
+  for (auto _ : state) {
+    tree.insert_or_assign(static_cast<int>(rng() % (count * 4)),
+                          static_cast<int64_t>(rng() % 1000));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void window_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Args({1000000, 4000})->Args({1000000, 400000});
+}
+
+BENCHMARK(bm_window_scan)->Apply(window_sizes);
+BENCHMARK(bm_window_aggregate)->Apply(window_sizes);
+BENCHMARK_TEMPLATE(bm_assign, plain_map)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_assign, sum_map)->Arg(1000000);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_set.h"
+
+// Один и тот же s21::set на красно-чёрном дереве и на B+-дереве с разным
+// числом значений в узле: поиск, полный обход и вставка в случайном порядке.
+
+static std::vector<int64_t> shuffled_keys(size_t count) {
+  std::vector<int64_t> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int64_t>(i) * 2;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  return keys;
+}
+
+template <typename set_type>
+static void bm_find(benchmark::State& state) {
+  std::vector<int64_t> keys = shuffled_keys(state.range(0));
+  set_type tree;
+  for (int64_t key : keys) tree.insert(key);
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int64_t> pick(0, 2 * keys.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tree.find(pick(rng)));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename set_type>
+static void bm_iterate(benchmark::State& state) {
+  std::vector<int64_t> keys = shuffled_keys(state.range(0));
+  set_type tree;
+  for (int64_t key : keys) tree.insert(key);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (int64_t key : tree) sum += key;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename set_type>
+static void bm_random_insert(benchmark::State& state) {
+  std::vector<int64_t> keys = shuffled_keys(state.range(0));
+  for (auto _ : state) {
+    set_type tree;
+    for (int64_t key : keys) tree.insert(key);
+    benchmark::DoNotOptimize(tree.size());
+    state.PauseTiming();
+    tree.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void b_tree_find_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(1000000)->Arg(10000000);
+}
+
+static void b_tree_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+}
+
+static void b_tree_build_sizes(benchmark::internal::Benchmark* bench) {
+  b_tree_sizes(bench);
+  bench->Iterations(3);
+}
+
+template <size_t fanout>
+using b_tree_set = s21::set<int64_t, std::less<int64_t>,
+                            std::allocator<int64_t>, s21::b_tree_nodes<fanout>>;
+using rb_tree_set = s21::set<int64_t>;
+
+BENCHMARK_TEMPLATE(bm_find, rb_tree_set)->Apply(b_tree_find_sizes);
+BENCHMARK_TEMPLATE(bm_find, b_tree_set<16>)->Apply(b_tree_find_sizes);
+BENCHMARK_TEMPLATE(bm_find, b_tree_set<64>)->Apply(b_tree_find_sizes);
+BENCHMARK_TEMPLATE(bm_find, b_tree_set<128>)->Apply(b_tree_find_sizes);
+BENCHMARK_TEMPLATE(bm_iterate, rb_tree_set)->Apply(b_tree_sizes);
+BENCHMARK_TEMPLATE(bm_iterate, b_tree_set<16>)->Apply(b_tree_sizes);
+BENCHMARK_TEMPLATE(bm_iterate, b_tree_set<64>)->Apply(b_tree_sizes);
+BENCHMARK_TEMPLATE(bm_iterate, b_tree_set<128>)->Apply(b_tree_sizes);
+BENCHMARK_TEMPLATE(bm_random_insert, rb_tree_set)->Apply(b_tree_build_sizes);
+BENCHMARK_TEMPLATE(bm_random_insert, b_tree_set<16>)
+    ->Apply(b_tree_build_sizes);
+BENCHMARK_TEMPLATE(bm_random_insert, b_tree_set<64>)
+    ->Apply(b_tree_build_sizes);
+BENCHMARK_TEMPLATE(bm_random_insert, b_tree_set<128>)
+    ->Apply(b_tree_build_sizes);
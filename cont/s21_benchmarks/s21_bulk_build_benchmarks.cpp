@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "../s21_library/s21_set.h"
+
+static std::vector<int> sorted_keys(size_t count) {
+  std::vector<int> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int>(i * 2);
+  return keys;
+}
+
+static void bm_set_insert_sorted(benchmark::State& state) {
+  std::vector<int> keys = sorted_keys(state.range(0));
+  for (auto _ : state) {
+    s21::set<int> tree;
+    for (int key : keys) tree.insert(key);
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bm_set_assign_sorted(benchmark::State& state) {
+  std::vector<int> keys = sorted_keys(state.range(0));
+  for (auto _ : state) {
+    s21::set<int> tree;
+    tree.assign_sorted(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bulk_build_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(bm_set_insert_sorted)->Apply(bulk_build_sizes);
+BENCHMARK(bm_set_assign_sorted)->Apply(bulk_build_sizes);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+#include "../s21_library/s21_concurrent_map.h"
+#include "../s21_library/s21_map.h"
+
+// Пропускная способность при 1..64 потоках: шардированный concurrent_map
+// против s21::map под одним общим мьютексом. Доля записей задаётся
+// аргументом: 5% — нагрузка на чтение, 50% — на запись.
+
+static constexpr int64_t key_space = 1 << 20;
+
+// прежняя схема: весь словарь за одним мьютексом
+class locked_map {
+ public:
+  bool find(int64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return map_.contains(key);
+  }
+  void write(int64_t key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (key & 1) {
+      map_.insert_or_assign(key, key);
+    } else {
+      auto it = map_.find(key);
+      if (it != map_.end()) map_.erase(it);
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  s21::map<int64_t, int64_t> map_;
+};
+
+class sharded_map {
+ public:
+  bool find(int64_t key) { return map_.contains(key); }
+  void write(int64_t key) {
+    if (key & 1) {
+      map_.insert_or_assign(key, key);
+    } else {
+      map_.erase(key);
+    }
+  }
+
+ private:
+  s21::concurrent_map<int64_t, int64_t> map_;
+};
+
+template <typename map_type>
+static map_type& shared_table() {
+  static map_type* table = [] {
+    auto* created = new map_type;
+    for (int64_t key = 0; key < key_space; key += 2) created->write(key + 1);
+    return created;
+  }();
+  return *table;
+}
+
+template <typename map_type>
+static void bm_mixed(benchmark::State& state) {
+  map_type& table = shared_table<map_type>();
+  std::mt19937_64 rng(state.thread_index() + 1);
+  std::uniform_int_distribution<int64_t> pick(0, key_space - 1);
+  std::uniform_int_distribution<int> percent(0, 99);
+  const int write_share = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    int64_t key = pick(rng);
+    if (percent(rng) < write_share) {
+      table.write(key);
+    } else {
+      benchmark::DoNotOptimize(table.find(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(bm_mixed, locked_map)
+    ->Arg(5)
+    ->Arg(50)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(bm_mixed, sharded_map)
+    ->Arg(5)
+    ->Arg(50)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
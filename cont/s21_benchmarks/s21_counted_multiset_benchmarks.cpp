@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_multiset.h"
+
+// Гистограмма: много повторов немногих значений. Обычный multiset
+// выделяет узел на каждый повтор, counted_nodes — узел на значение.
+// Аргументы: число вставок и число различных значений.
+
+using node_multiset = s21::multiset<int>;
+using counted_multiset =
+    s21::multiset<int, std::less<int>, std::allocator<int>,
+                  s21::counted_nodes>;
+
+static std::vector<int> samples(size_t count, size_t distinct) {
+  std::vector<int> values(count);
+  std::mt19937 rng(17);
+  for (int& value : values) value = static_cast<int>(rng() % distinct);
+  return values;
+}
+
+template <typename multiset_type>
+static void bm_insert(benchmark::State& state) {
+  std::vector<int> values = samples(state.range(0), state.range(1));
+  for (auto _ : state) {
+    multiset_type histogram;
+    for (int value : values) histogram.insert(value);
+    benchmark::DoNotOptimize(histogram.size());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <typename multiset_type>
+static void bm_count(benchmark::State& state) {
+  std::vector<int> values = samples(state.range(0), state.range(1));
+  multiset_type histogram;
+  for (int value : values) histogram.insert(value);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(histogram.count(values[i]));
+    if (++i == values.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename multiset_type>
+static void bm_erase_one(benchmark::State& state) {
+  std::vector<int> values = samples(state.range(0), state.range(1));
+  multiset_type histogram;
+  for (int value : values) histogram.insert(value);
+  size_t i = 0;
+  for (auto _ : state) {
+    // удалённый повтор сразу возвращается, размер не меняется
+    histogram.erase(histogram.find(values[i]));
+    histogram.insert(values[i]);
+    if (++i == values.size()) i = 0;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void histogram_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Args({1 << 20, 4096})->Args({1 << 22, 256});
+}
+
+BENCHMARK_TEMPLATE(bm_insert, node_multiset)->Apply(histogram_sizes);
+BENCHMARK_TEMPLATE(bm_insert, counted_multiset)->Apply(histogram_sizes);
+BENCHMARK_TEMPLATE(bm_count, node_multiset)->Apply(histogram_sizes);
+BENCHMARK_TEMPLATE(bm_count, counted_multiset)->Apply(histogram_sizes);
+BENCHMARK_TEMPLATE(bm_erase_one, node_multiset)->Apply(histogram_sizes);
+BENCHMARK_TEMPLATE(bm_erase_one, counted_multiset)->Apply(histogram_sizes);
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_flat_set.h"
+#include "../s21_library/s21_frozen_set.h"
+#include "../s21_library/s21_set.h"
+
+// contains случайных ключей, половина отсутствует: живое красно-чёрное
+// дерево, двоичный поиск flat_set и frozen_set в порядке Эйтцингера.
+// Ключи 32-битные, чтобы 100M поместились в память: frozen_set и flat_set
+// занимают по 400 МБ, а rb_tree на 100M узлов (около 4,8 ГБ) не влезает,
+// поэтому живое дерево меряется до 10M.
+
+static constexpr size_t probe_count = 1 << 20;
+
+// ключи 0, 2, 4, ... без промежуточного вектора
+struct even_keys {
+  int32_t value;
+  int32_t operator*() const { return value; }
+  even_keys& operator++() {
+    value += 2;
+    return *this;
+  }
+};
+
+static std::vector<int32_t> probes(size_t count) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int32_t> pick(0,
+                                              static_cast<int32_t>(2 * count));
+  std::vector<int32_t> keys(probe_count);
+  for (int32_t& key : keys) key = pick(rng);
+  return keys;
+}
+
+static s21::set<int32_t> build_live(size_t count) {
+  s21::set<int32_t> live;
+  std::vector<int32_t> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int32_t>(2 * i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  for (int32_t key : keys) live.insert(key);
+  return live;
+}
+
+template <typename set_type>
+static void run_lookups(benchmark::State& state, const set_type& keys) {
+  std::vector<int32_t> targets = probes(state.range(0));
+  size_t i = 0;
+  size_t hits = 0;
+  for (auto _ : state) {
+    hits += keys.contains(targets[i]);
+    i = (i + 1) & (probe_count - 1);
+  }
+  benchmark::DoNotOptimize(hits);
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void bm_contains_live(benchmark::State& state) {
+  run_lookups(state, build_live(state.range(0)));
+}
+
+static void bm_contains_flat(benchmark::State& state) {
+  std::vector<int32_t> keys(state.range(0));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int32_t>(2 * i);
+  }
+  run_lookups(state, s21::flat_set<int32_t>(keys.begin(), keys.end()));
+}
+
+static void bm_contains_frozen(benchmark::State& state) {
+  run_lookups(state, s21::frozen_set<int32_t>::from_sorted(even_keys{0},
+                                                           state.range(0)));
+}
+
+// замораживание дерева из 1M и 10M узлов
+static void bm_freeze(benchmark::State& state) {
+  const s21::set<int32_t> live = build_live(state.range(0));
+  for (auto _ : state) benchmark::DoNotOptimize(live.freeze().size());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(bm_contains_live)->Arg(1000000)->Arg(10000000);
+BENCHMARK(bm_contains_flat)->Arg(1000000)->Arg(10000000)->Arg(100000000);
+BENCHMARK(bm_contains_frozen)->Arg(1000000)->Arg(10000000)->Arg(100000000);
+BENCHMARK(bm_freeze)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <set>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+#include "../s21_library/s21_set.h"
+
+// ключи временного ряда: почти всегда приходят по возрастанию
+static std::vector<int> monotonic_keys(size_t count) {
+  std::vector<int> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int>(i);
+  return keys;
+}
+
+template <typename set_type>
+static void bm_monotonic_insert(benchmark::State& state) {
+  std::vector<int> keys = monotonic_keys(state.range(0));
+  for (auto _ : state) {
+    set_type tree;
+    for (int key : keys) tree.insert(key);
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename set_type>
+static void bm_monotonic_insert_hint(benchmark::State& state) {
+  std::vector<int> keys = monotonic_keys(state.range(0));
+  for (auto _ : state) {
+    set_type tree;
+    for (int key : keys) tree.insert(tree.cend(), key);
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bm_map_monotonic_emplace_hint(benchmark::State& state) {
+  std::vector<int> keys = monotonic_keys(state.range(0));
+  for (auto _ : state) {
+    s21::map<int, int> tree;
+    for (int key : keys) tree.emplace_hint(tree.cend(), key, key);
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void hint_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(bm_monotonic_insert, s21::set<int>)->Apply(hint_sizes);
+BENCHMARK_TEMPLATE(bm_monotonic_insert_hint, s21::set<int>)
+    ->Apply(hint_sizes);
+BENCHMARK_TEMPLATE(bm_monotonic_insert, std::set<int>)->Apply(hint_sizes);
+BENCHMARK_TEMPLATE(bm_monotonic_insert_hint, std::set<int>)
+    ->Apply(hint_sizes);
+BENCHMARK(bm_map_monotonic_emplace_hint)->Apply(hint_sizes);
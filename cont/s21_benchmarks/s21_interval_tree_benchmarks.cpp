@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../s21_library/s21_interval_tree.h"
+#include "../s21_library/s21_map.h"
+
+// Какие отрезки времени пересекают запрос: линейный проход по
+// s21::map<start, end> против interval_tree. Отрезки короткие, поэтому
+// ответов немного, и вся разница — в просмотренных узлах.
+
+static std::vector<std::pair<int, int>> ranges(size_t count) {
+  std::mt19937 rng(3);
+  std::vector<std::pair<int, int>> items(count);
+  for (auto& item : items) {
+    item.first = static_cast<int>(rng() % (count * 100));
+    item.second = item.first + 1 + static_cast<int>(rng() % 500);
+  }
+  return items;
+}
+
+static void bm_overlap_scan(benchmark::State& state) {
+  size_t count = state.range(0);
+  s21::map<int, int> starts;
+  for (const auto& item : ranges(count)) starts.insert(item);
+  std::mt19937 rng(9);
+  size_t hits = 0;
+  for (auto _ : state) {
+    int lo = static_cast<int>(rng() % (count * 100));
+    int hi = lo + 100;
+    for (auto it = starts.begin(); it != starts.end(); ++it) {
+      hits += it->first < hi && lo < it->second;
+    }
+  }
+  benchmark::DoNotOptimize(hits);
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void bm_overlap_tree(benchmark::State& state) {
+  size_t count = state.range(0);
+  s21::interval_tree<int> tree;
+  for (const auto& item : ranges(count)) tree.insert(item);
+  std::mt19937 rng(9);
+  size_t hits = 0;
+  for (auto _ : state) {
+    int lo = static_cast<int>(rng() % (count * 100));
+    tree.overlapping(lo, lo + 100,
+                     [&hits](const std::pair<int, int>&) { ++hits; });
+  }
+  benchmark::DoNotOptimize(hits);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bm_overlap_scan)->Arg(10000)->Arg(1000000);
+BENCHMARK(bm_overlap_tree)->Arg(10000)->Arg(1000000);
@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+#include "../s21_library/s21_set.h"
+
+// Основное сравнение — одно и то же s21::rb_tree с node_pool и с
+// per_node_allocation, где каждый узел идёт через свой new/delete, как до
+// появления пула: балансировка и путь вставки у них общие, и разница
+// сводится к выделению памяти. std::set и std::map — дополнительный
+// ориентир с другой реализацией дерева.
+
+template <typename T>
+struct per_node_allocator {
+  using value_type = T;
+
+  per_node_allocator() = default;
+  template <typename U>
+  per_node_allocator(const per_node_allocator<U>&) {}
+
+  T* allocate(size_t n) { return std::allocator<T>().allocate(n); }
+  void deallocate(T* ptr, size_t n) { std::allocator<T>().deallocate(ptr, n); }
+
+  bool operator==(const per_node_allocator&) const { return true; }
+  bool operator!=(const per_node_allocator&) const { return false; }
+};
+
+namespace s21 {
+template <typename T>
+struct per_node_allocation<per_node_allocator<T>> : std::true_type {};
+}  // namespace s21
+
+static std::vector<int> random_keys(size_t count) {
+  std::vector<int> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  return keys;
+}
+
+template <typename set_type>
+static void bm_set_ingest(benchmark::State& state) {
+  std::vector<int> keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    set_type tree;
+    for (int key : keys) tree.insert(key);
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename map_type>
+static void bm_map_ingest(benchmark::State& state) {
+  std::vector<int> keys = random_keys(state.range(0));
+  for (auto _ : state) {
+    map_type tree;
+    for (int key : keys) tree.insert({key, key});
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename set_type>
+static void bm_set_churn(benchmark::State& state) {
+  std::vector<int> keys = random_keys(state.range(0));
+  set_type tree;
+  for (int key : keys) tree.insert(key);
+  for (auto _ : state) {
+    for (size_t i = 0; i < keys.size(); i += 2) tree.erase(tree.find(keys[i]));
+    for (size_t i = 0; i < keys.size(); i += 2) tree.insert(keys[i]);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void pool_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+}
+
+using per_node_set = s21::set<int, std::less<int>, per_node_allocator<int>>;
+using s21_int_map = s21::map<int, int>;
+using per_node_map =
+    s21::map<int, int, std::less<int>,
+             per_node_allocator<std::pair<const int, int>>>;
+using std_int_map = std::map<int, int>;
+
+BENCHMARK_TEMPLATE(bm_set_ingest, s21::set<int>)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_set_ingest, per_node_set)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_set_ingest, std::set<int>)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_map_ingest, s21_int_map)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_map_ingest, per_node_map)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_map_ingest, std_int_map)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_set_churn, s21::set<int>)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_set_churn, per_node_set)->Apply(pool_sizes);
+BENCHMARK_TEMPLATE(bm_set_churn, std::set<int>)->Apply(pool_sizes);
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+
+// Снимок словаря для отчёта: обычная копия (узлы из одного заранее
+// выделенного слэба) против параллельной, где верхние уровни делятся
+// между потоками. Второй аргумент — число потоков.
+
+using map_type = s21::map<int64_t, int64_t>;
+
+static map_type build(size_t count) {
+  std::vector<int64_t> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int64_t>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+  map_type tree;
+  for (int64_t key : keys) tree.insert({key, key});
+  return tree;
+}
+
+static void bm_copy(benchmark::State& state) {
+  const map_type source = build(state.range(0));
+  for (auto _ : state) {
+    map_type copy(source);
+    benchmark::DoNotOptimize(copy.size());
+    state.PauseTiming();
+    copy = map_type();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void bm_copy_parallel(benchmark::State& state) {
+  const map_type source = build(state.range(0));
+  s21::parallel_options options;
+  options.threads = state.range(1);
+  for (auto _ : state) {
+    map_type copy(source, options);
+    benchmark::DoNotOptimize(copy.size());
+    state.PauseTiming();
+    copy = map_type();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(bm_copy)
+    ->Arg(1000000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(bm_copy_parallel)
+    ->Args({1000000, 4})
+    ->Args({10000000, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
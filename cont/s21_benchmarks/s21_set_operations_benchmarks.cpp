@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_set.h"
+
+// два множества одного порядка с частично пересекающимися ключами
+static std::vector<int> random_keys(size_t count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<int> keys(count);
+  for (int& key : keys) key = static_cast<int>(rng() % (count * 4));
+  return keys;
+}
+
+static void bm_merge_union(benchmark::State& state) {
+  std::vector<int> left = random_keys(state.range(0), 1);
+  std::vector<int> right = random_keys(state.range(0), 2);
+  for (auto _ : state) {
+    state.PauseTiming();
+    s21::set<int> first(left.begin(), left.end());
+    s21::set<int> second(right.begin(), right.end());
+    state.ResumeTiming();
+    first.merge(second);
+    benchmark::DoNotOptimize(first.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+static void bm_split_join_union(benchmark::State& state) {
+  std::vector<int> left = random_keys(state.range(0), 1);
+  std::vector<int> right = random_keys(state.range(0), 2);
+  s21::parallel_options options;
+  options.threads = state.range(1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    s21::set<int> first(left.begin(), left.end());
+    s21::set<int> second(right.begin(), right.end());
+    state.ResumeTiming();
+    auto united =
+        s21::set<int>::set_union(std::move(first), std::move(second), options);
+    benchmark::DoNotOptimize(united.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+static void bm_split_join_intersection(benchmark::State& state) {
+  std::vector<int> left = random_keys(state.range(0), 1);
+  std::vector<int> right = random_keys(state.range(0), 2);
+  s21::parallel_options options;
+  options.threads = state.range(1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    s21::set<int> first(left.begin(), left.end());
+    s21::set<int> second(right.begin(), right.end());
+    state.ResumeTiming();
+    auto common = s21::set<int>::set_intersection(std::move(first),
+                                                  std::move(second), options);
+    benchmark::DoNotOptimize(common.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+BENCHMARK(bm_merge_union)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_split_join_union)
+    ->ArgsProduct({{100000, 1000000}, {1, 4, 32}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_split_join_intersection)
+    ->ArgsProduct({{100000, 1000000}, {1, 4, 32}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+
+// Читателю нужна неизменная версия словаря, пока писатель продолжает
+// запись. У обычного map это полная копия дерева, у persistent_nodes —
+// snapshot() за O(1) и копирование общих узлов на пути первых записей.
+// Итерация: снимок и затем writes изменений случайных ключей.
+
+using rb_map = s21::map<int, int>;
+using persistent_map =
+    s21::map<int, int, std::less<int>, std::allocator<std::pair<int, int>>,
+             s21::persistent_nodes>;
+
+template <typename map_type>
+static void fill(map_type& tree, size_t count) {
+  std::vector<int> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (int key : keys) tree.insert_or_assign(key, key);
+}
+
+static rb_map take_snapshot(const rb_map& tree) { return rb_map(tree); }
+static persistent_map take_snapshot(const persistent_map& tree) {
+  return tree.snapshot();
+}
+
+template <typename map_type>
+static void bm_snapshot_then_write(benchmark::State& state) {
+  size_t count = state.range(0);
+  size_t writes = state.range(1);
+  map_type tree;
+  fill(tree, count);
+  std::mt19937 rng(11);
+  for (auto _ : state) {
+    map_type snapshot = take_snapshot(tree);
+    for (size_t i = 0; i < writes; ++i) {
+      int key = static_cast<int>(rng() % count);
+      tree.insert_or_assign(key, key + 1);
+    }
+    benchmark::DoNotOptimize(snapshot.size());
+    state.PauseTiming();
+    // старая версия разрушается вне замера, как у читателя в другом потоке
+    snapshot = map_type();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * writes);
+}
+
+template <typename map_type>
+static void bm_find(benchmark::State& state) {
+  size_t count = state.range(0);
+  map_type tree;
+  fill(tree, count);
+  std::mt19937 rng(13);
+  for (auto _ : state) {
+    int key = static_cast<int>(rng() % count);
+    benchmark::DoNotOptimize(tree.find(key));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void snapshot_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Args({100000, 1})->Args({100000, 1000});
+  bench->Args({1000000, 1})->Args({1000000, 1000});
+  bench->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_TEMPLATE(bm_snapshot_then_write, rb_map)->Apply(snapshot_sizes);
+BENCHMARK_TEMPLATE(bm_snapshot_then_write, persistent_map)
+    ->Apply(snapshot_sizes);
+BENCHMARK_TEMPLATE(bm_find, rb_map)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_find, persistent_map)->Arg(1000000);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+
+// Время измеряется только для разрушения дерева: clear() против удаления
+// элементов по одному (так clear() работал раньше, через erase корня).
+
+template <typename map_type>
+static void fill(map_type& tree, size_t count) {
+  std::vector<int> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<int>(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (int key : keys) tree.insert({key, typename map_type::mapped_type()});
+}
+
+template <typename map_type>
+static void bm_clear(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    map_type tree;
+    fill(tree, state.range(0));
+    state.ResumeTiming();
+    tree.clear();
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename map_type>
+static void bm_erase_one_by_one(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    map_type tree;
+    fill(tree, state.range(0));
+    state.ResumeTiming();
+    while (!tree.empty()) tree.erase(tree.begin());
+    benchmark::DoNotOptimize(tree.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void teardown_sizes(benchmark::internal::Benchmark* bench) {
+  bench->Arg(1000000)->Arg(10000000)->Unit(benchmark::kMillisecond);
+  bench->Iterations(3);
+}
+
+using s21_int_map = s21::map<int, int>;
+using s21_string_map = s21::map<int, std::string>;
+using std_string_map = std::map<int, std::string>;
+
+BENCHMARK_TEMPLATE(bm_clear, s21_int_map)->Apply(teardown_sizes);
+BENCHMARK_TEMPLATE(bm_erase_one_by_one, s21_int_map)->Apply(teardown_sizes);
+BENCHMARK_TEMPLATE(bm_clear, s21_string_map)->Apply(teardown_sizes);
+BENCHMARK_TEMPLATE(bm_erase_one_by_one, s21_string_map)
+    ->Apply(teardown_sizes);
+BENCHMARK_TEMPLATE(bm_clear, std_string_map)->Apply(teardown_sizes);
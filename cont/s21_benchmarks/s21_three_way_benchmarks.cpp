@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+#include "../s21_library/s21_set.h"
+
+// find случайных существующих ключей: std::less на арифметическом ключе
+// идёт по трёхстороннему спуску child_[order > 0], а тот же порядок,
+// заданный своим компаратором, — по общему пути с двумя сравнениями и
+// ветвлением на каждом уровне. 256 и 4K узлов помещаются в кэш, и разница
+// там сводится к промахам предсказателя переходов; на 1M её частично
+// скрывают промахи кэша.
+
+static constexpr size_t probe_count = 1 << 20;
+
+// тот же порядок, что std::less, но не узнаётся деревом как стандартный
+template <typename Key>
+struct two_way_less {
+  bool operator()(const Key& a, const Key& b) const { return a < b; }
+};
+
+template <typename Key>
+static std::vector<Key> shuffled_keys(size_t count) {
+  std::vector<Key> keys(count);
+  for (size_t i = 0; i < count; ++i) keys[i] = static_cast<Key>(3 * i + 1);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  return keys;
+}
+
+template <typename Key>
+static std::vector<Key> probes(const std::vector<Key>& keys) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+  std::vector<Key> targets(probe_count);
+  for (Key& target : targets) target = keys[pick(rng)];
+  return targets;
+}
+
+template <typename tree_type, typename Key>
+static void run_finds(benchmark::State& state, const tree_type& tree,
+                      const std::vector<Key>& targets) {
+  size_t i = 0;
+  size_t hits = 0;
+  for (auto _ : state) {
+    hits += tree.contains(targets[i]);
+    i = (i + 1) & (probe_count - 1);
+  }
+  benchmark::DoNotOptimize(hits);
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename compare>
+static void bm_set_find(benchmark::State& state) {
+  std::vector<int32_t> keys = shuffled_keys<int32_t>(state.range(0));
+  s21::set<int32_t, compare> tree;
+  for (int32_t key : keys) tree.insert(key);
+  run_finds(state, tree, probes(keys));
+}
+
+template <typename compare>
+static void bm_map_find(benchmark::State& state) {
+  std::vector<uint64_t> keys = shuffled_keys<uint64_t>(state.range(0));
+  s21::map<uint64_t, int, compare> tree;
+  for (uint64_t key : keys) tree.insert(key, 0);
+  run_finds(state, tree, probes(keys));
+}
+
+BENCHMARK_TEMPLATE(bm_set_find, std::less<int32_t>)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_set_find, two_way_less<int32_t>)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_map_find, std::less<uint64_t>)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_map_find, two_way_less<uint64_t>)
+    ->Arg(256)
+    ->Arg(4096)
+    ->Arg(1000000);
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../s21_library/s21_map.h"
+#include "../s21_library/s21_unordered_map.h"
+
+// Точечные запросы к таблице: попадания и промахи. s21::map добавлен для
+// сравнения с упорядоченным контейнером.
+
+template <typename map_type>
+static void fill(map_type& table, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    table.insert({static_cast<int64_t>(i) * 2, static_cast<int64_t>(i)});
+  }
+}
+
+template <typename map_type>
+static void bm_lookup_hit(benchmark::State& state) {
+  map_type table;
+  fill(table, state.range(0));
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<int64_t> pick(0, state.range(0) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(table.find(pick(rng) * 2));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename map_type>
+static void bm_lookup_miss(benchmark::State& state) {
+  map_type table;
+  fill(table, state.range(0));
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<int64_t> pick(0, state.range(0) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(table.find(pick(rng) * 2 + 1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+template <typename map_type>
+static void bm_insert(benchmark::State& state) {
+  for (auto _ : state) {
+    map_type table;
+    fill(table, state.range(0));
+    benchmark::DoNotOptimize(table.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using s21_hash_map = s21::unordered_map<int64_t, int64_t>;
+using std_hash_map = std::unordered_map<int64_t, int64_t>;
+using s21_tree_map = s21::map<int64_t, int64_t>;
+
+BENCHMARK_TEMPLATE(bm_lookup_hit, s21_hash_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_lookup_hit, std_hash_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_lookup_hit, s21_tree_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_lookup_miss, s21_hash_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_lookup_miss, std_hash_map)->Arg(1000)->Arg(1000000);
+BENCHMARK_TEMPLATE(bm_insert, s21_hash_map)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_insert, std_hash_map)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
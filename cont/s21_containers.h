@@ -1,11 +1,18 @@
 #ifndef S21_CONTAINERS_H
 #define S21_CONTAINERS_H
 
+#include "s21_library/s21_concurrent_map.h"
+#include "s21_library/s21_flat_map.h"
+#include "s21_library/s21_flat_set.h"
+#include "s21_library/s21_frozen_set.h"
+#include "s21_library/s21_interval_tree.h"
 #include "s21_library/s21_list.h"
 #include "s21_library/s21_map.h"
 #include "s21_library/s21_queue.h"
 #include "s21_library/s21_set.h"
 #include "s21_library/s21_stack.h"
+#include "s21_library/s21_unordered_map.h"
+#include "s21_library/s21_unordered_set.h"
 #include "s21_library/s21_vector.h"
 
 #endif  // S21_CONTAINERS_H
\ No newline at end of file
@@ -0,0 +1,1138 @@
+#ifndef S21_B_TREE
+#define S21_B_TREE
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+// Политика узлов для set, multiset и map: вместо красно-чёрного дерева
+// контейнер строится на B+-дереве. fanout — сколько значений помещается в
+// лист и сколько потомков у внутреннего узла. Поиск читает по одному
+// непрерывному массиву на уровень, поэтому промахов кэша в log(fanout) раз
+// меньше, чем у rb_tree. Вставка и удаление сдвигают значения внутри листа
+// и делают недействительными итераторы на этот лист.
+template <size_t fanout = 64>
+struct b_tree_nodes {
+  static_assert(fanout >= 4, "b_tree_nodes: fanout must be at least 4");
+  static constexpr size_t node_fanout = fanout;
+};
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+class b_tree {
+ protected:
+  struct node;
+  struct leaf_node;
+  struct inner_node;
+
+ public:
+  using key_type =
+      std::decay_t<std::invoke_result_t<key_of, const data_type&>>;
+  class iterator;
+  class const_iterator;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  b_tree() : root_(nullptr), first_(nullptr), last_(nullptr), size_(0) {}
+  explicit b_tree(const allocator& alloc)
+      : root_(nullptr),
+        first_(nullptr),
+        last_(nullptr),
+        size_(0),
+        alloc_(alloc) {}
+  b_tree(const b_tree& other);
+  b_tree(b_tree&& other) noexcept;
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  b_tree(input_iterator first, input_iterator last) : b_tree() {
+    assign_range(first, last, true);
+  }
+  ~b_tree() { clear(); }
+
+  b_tree& operator=(b_tree&& other) noexcept;
+
+  iterator begin() { return iterator(first_, 0, this); }
+  iterator end() { return iterator(nullptr, 0, this); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+  const_iterator cbegin() const { return const_iterator(first_, 0, this); }
+  const_iterator cend() const { return const_iterator(nullptr, 0, this); }
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(cend());
+  }
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(cbegin());
+  }
+
+  template <typename other_key>
+  iterator find(const other_key& key);
+  template <typename other_key>
+  const_iterator find(const other_key& key) const;
+  template <typename other_key>
+  bool contains(const other_key& key) const {
+    return find(key) != cend();
+  }
+  template <typename other_key>
+  iterator lower_bound(const other_key& key) {
+    auto found = lower_position(key);
+    return iterator(found.first, found.second, this);
+  }
+  template <typename other_key>
+  const_iterator lower_bound(const other_key& key) const {
+    auto found = lower_position(key);
+    return const_iterator(found.first, found.second, this);
+  }
+  template <typename other_key>
+  iterator upper_bound(const other_key& key) {
+    auto found = upper_position(key);
+    return iterator(found.first, found.second, this);
+  }
+  template <typename other_key>
+  const_iterator upper_bound(const other_key& key) const {
+    auto found = upper_position(key);
+    return const_iterator(found.first, found.second, this);
+  }
+  template <typename other_key>
+  std::pair<iterator, iterator> equal_range(const other_key& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename other_key>
+  std::pair<const_iterator, const_iterator> equal_range(
+      const other_key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  // fn(value) для каждого значения с ключом из [lo, hi) по порядку: один
+  // спуск к lo, дальше проход по списку листьев
+  template <typename function>
+  void for_each_in_range(const key_type& lo, const key_type& hi,
+                         function&& fn);
+  template <typename function>
+  void for_each_in_range(const key_type& lo, const key_type& hi,
+                         function&& fn) const {
+    auto visit = [&fn](const data_type& data) { fn(data); };
+    const_cast<b_tree*>(this)->for_each_in_range(lo, hi, visit);
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  size_t max_size() const noexcept {
+    return std::allocator_traits<allocator>::max_size(alloc_);
+  }
+  allocator get_allocator() const { return alloc_; }
+
+  void clear() noexcept;
+  void erase(iterator pos);
+  void swap(b_tree& other) noexcept;
+
+ protected:
+  // общий заголовок листьев и внутренних узлов
+  struct node {
+    inner_node* parent_ = nullptr;
+    unsigned count_ = 0;
+    bool leaf_;
+    explicit node(bool leaf) : leaf_(leaf) {}
+  };
+
+  // значения лежат только в листьях; листья связаны в список для обхода
+  struct leaf_node : node {
+    leaf_node* prev_ = nullptr;
+    leaf_node* next_ = nullptr;
+    union {
+      data_type values_[fanout];
+    };
+    leaf_node() : node(true) {}
+    ~leaf_node() {}
+  };
+
+  // keys_[i] разделяет потомков i и i + 1: ключи слева не больше, справа
+  // не меньше него
+  struct inner_node : node {
+    union {
+      key_type keys_[fanout - 1];
+    };
+    node* children_[fanout];
+    inner_node() : node(false) {}
+    ~inner_node() {}
+  };
+
+  using leaf_allocator =
+      typename std::allocator_traits<allocator>::template rebind_alloc<
+          leaf_node>;
+  using inner_allocator =
+      typename std::allocator_traits<allocator>::template rebind_alloc<
+          inner_node>;
+
+  // место для вставки: лист и индекс в нём, либо уже существующий ключ
+  struct insert_position {
+    leaf_node* leaf_;
+    size_t index_;
+    bool existing_;
+  };
+
+  node* root_;
+  leaf_node* first_;
+  leaf_node* last_;
+  size_t size_;
+  compare compare_;
+  allocator alloc_;
+
+  static const key_type& value_key(const data_type& value) {
+    return key_of()(value);
+  }
+
+  template <typename value_arg>
+  std::pair<iterator, bool> insert_value(bool unique, value_arg&& value) {
+    return emplace_hint_value(unique, const_iterator(),
+                              std::forward<value_arg>(value));
+  }
+  template <typename value_arg>
+  std::pair<iterator, bool> insert_hint_value(bool unique, const_iterator hint,
+                                              value_arg&& value) {
+    return emplace_hint_value(unique, hint, std::forward<value_arg>(value));
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_value(bool unique, Args&&... args) {
+    return emplace_hint_value(unique, const_iterator(),
+                              std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint_value(bool unique,
+                                               const_iterator hint,
+                                               Args&&... args);
+  template <typename input_iterator>
+  void assign_range(input_iterator first, input_iterator last, bool unique);
+  void merge_values(b_tree& other, bool unique);
+
+  template <typename other_key>
+  insert_position find_insert_position(const other_key& key,
+                                       bool unique) const;
+  template <typename other_key>
+  insert_position find_hint_position(const_iterator hint,
+                                     const other_key& key, bool unique) const;
+  iterator insert_at(insert_position position, data_type&& value);
+  iterator insert_split(leaf_node* leaf, size_t index, data_type&& value);
+  void place_value(leaf_node* leaf, size_t index, data_type&& value);
+
+  template <typename other_key>
+  std::pair<leaf_node*, size_t> lower_position(const other_key& key) const;
+  template <typename other_key>
+  std::pair<leaf_node*, size_t> upper_position(const other_key& key) const;
+  template <typename other_key>
+  size_t lower_index(const leaf_node* leaf, const other_key& key) const;
+  template <typename other_key>
+  size_t upper_index(const leaf_node* leaf, const other_key& key) const;
+  template <typename other_key>
+  size_t lower_child(const inner_node* inner, const other_key& key) const {
+    return std::lower_bound(inner->keys_, inner->keys_ + inner->count_ - 1,
+                            key, compare_) -
+           inner->keys_;
+  }
+  template <typename other_key>
+  size_t upper_child(const inner_node* inner, const other_key& key) const {
+    return std::upper_bound(inner->keys_, inner->keys_ + inner->count_ - 1,
+                            key, compare_) -
+           inner->keys_;
+  }
+  static size_t child_index(const inner_node* parent, const node* child);
+
+  leaf_node* create_leaf();
+  inner_node* create_inner();
+  void destroy_leaf(leaf_node* leaf) noexcept;
+  void destroy_inner(inner_node* inner) noexcept;
+  void destroy_subtree(node* node_curr) noexcept;
+  node* copy_subtree(const node* src, inner_node* parent);
+
+  inner_node* reserve_inners(inner_node* parent);
+  static inner_node* take_inner(inner_node*& spare) noexcept;
+  void release_inners(inner_node* spare) noexcept;
+  void split_leaf(leaf_node* leaf, size_t keep, leaf_node* right);
+  void insert_child(inner_node* parent, node* left, key_type&& separator,
+                    node* right, inner_node*& spare);
+  void insert_into(inner_node* inner, size_t pos, key_type&& separator,
+                   node* right);
+  void remove_child(inner_node* inner, size_t key_index) noexcept;
+  void rebalance_leaf(leaf_node* leaf);
+  void rebalance_inner(inner_node* inner);
+  void merge_leaves(leaf_node* left, leaf_node* right, size_t key_index);
+  void merge_inners(inner_node* left, inner_node* right, size_t key_index);
+
+  template <typename value_type, typename... Args>
+  static void construct_at(value_type* place, Args&&... args) {
+    ::new (static_cast<void*>(place)) value_type(std::forward<Args>(args)...);
+  }
+  // перенос значения в неинициализированную ячейку
+  template <typename value_type>
+  static void relocate(value_type* from, value_type* to) {
+    construct_at(to, std::move(*from));
+    std::destroy_at(from);
+  }
+};
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+class b_tree<data_type, compare, allocator, key_of, fanout>::iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = data_type*;
+  using reference = data_type&;
+
+  iterator() : leaf_(nullptr), index_(0), tree_(nullptr) {}
+  iterator(leaf_node* leaf, size_t index, b_tree* tree)
+      : leaf_(leaf), index_(index), tree_(tree) {}
+
+  data_type& operator*() const { return leaf_->values_[index_]; }
+  data_type* operator->() const { return leaf_->values_ + index_; }
+  iterator& operator++() {
+    if (++index_ == leaf_->count_) {
+      leaf_ = leaf_->next_;
+      index_ = 0;
+    }
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator copy = *this;
+    ++*this;
+    return copy;
+  }
+  iterator& operator--() {
+    if (!leaf_) {
+      leaf_ = tree_->last_;
+      index_ = leaf_->count_;
+    } else if (index_ == 0) {
+      leaf_ = leaf_->prev_;
+      index_ = leaf_->count_;
+    }
+    --index_;
+    return *this;
+  }
+  iterator operator--(int) {
+    iterator copy = *this;
+    --*this;
+    return copy;
+  }
+  bool operator==(const iterator& other) const {
+    return leaf_ == other.leaf_ && index_ == other.index_;
+  }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+
+ private:
+  friend class b_tree;
+  leaf_node* leaf_;
+  size_t index_;
+  b_tree* tree_;
+};
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+class b_tree<data_type, compare, allocator, key_of, fanout>::const_iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const data_type*;
+  using reference = const data_type&;
+
+  const_iterator() : leaf_(nullptr), index_(0), tree_(nullptr) {}
+  const_iterator(leaf_node* leaf, size_t index, const b_tree* tree)
+      : leaf_(leaf), index_(index), tree_(tree) {}
+  const_iterator(const iterator& other)
+      : leaf_(other.leaf_), index_(other.index_), tree_(other.tree_) {}
+
+  const data_type& operator*() const { return leaf_->values_[index_]; }
+  const data_type* operator->() const { return leaf_->values_ + index_; }
+  const_iterator& operator++() {
+    if (++index_ == leaf_->count_) {
+      leaf_ = leaf_->next_;
+      index_ = 0;
+    }
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator copy = *this;
+    ++*this;
+    return copy;
+  }
+  const_iterator& operator--() {
+    if (!leaf_) {
+      leaf_ = tree_->last_;
+      index_ = leaf_->count_;
+    } else if (index_ == 0) {
+      leaf_ = leaf_->prev_;
+      index_ = leaf_->count_;
+    }
+    --index_;
+    return *this;
+  }
+  const_iterator operator--(int) {
+    const_iterator copy = *this;
+    --*this;
+    return copy;
+  }
+  bool operator==(const const_iterator& other) const {
+    return leaf_ == other.leaf_ && index_ == other.index_;
+  }
+  bool operator!=(const const_iterator& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  friend class b_tree;
+  leaf_node* leaf_;
+  size_t index_;
+  const b_tree* tree_;
+};
+}  // namespace s21
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::b_tree(
+    const b_tree& other)
+    : root_(nullptr),
+      first_(nullptr),
+      last_(nullptr),
+      size_(0),
+      compare_(other.compare_),
+      alloc_(other.alloc_) {
+  // копия повторяет форму исходного дерева, листья связываются по ходу
+  root_ = copy_subtree(other.root_, nullptr);
+  size_ = other.size_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::b_tree(
+    b_tree&& other) noexcept
+    : root_(other.root_),
+      first_(other.first_),
+      last_(other.last_),
+      size_(other.size_),
+      compare_(std::move(other.compare_)),
+      alloc_(std::move(other.alloc_)) {
+  other.root_ = nullptr;
+  other.first_ = other.last_ = nullptr;
+  other.size_ = 0;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+s21::b_tree<data_type, compare, allocator, key_of, fanout>&
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::operator=(
+    b_tree&& other) noexcept {
+  if (this != &other) {
+    clear();
+    swap(other);
+  }
+  return *this;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of,
+                 fanout>::clear() noexcept {
+  destroy_subtree(root_);
+  root_ = nullptr;
+  first_ = last_ = nullptr;
+  size_ = 0;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::swap(
+    b_tree& other) noexcept {
+  using std::swap;
+  swap(root_, other.root_);
+  swap(first_, other.first_);
+  swap(last_, other.last_);
+  swap(size_, other.size_);
+  swap(compare_, other.compare_);
+  swap(alloc_, other.alloc_);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::iterator
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::find(
+    const other_key& key) {
+  auto found = lower_position(key);
+  if (!found.first) return end();
+  const data_type& value = found.first->values_[found.second];
+  if (compare_(key, value_key(value))) return end();
+  return iterator(found.first, found.second, this);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+typename s21::b_tree<data_type, compare, allocator, key_of,
+                     fanout>::const_iterator
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::find(
+    const other_key& key) const {
+  return const_cast<b_tree*>(this)->find(key);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename function>
+void s21::b_tree<data_type, compare, allocator, key_of,
+                 fanout>::for_each_in_range(const key_type& lo,
+                                            const key_type& hi,
+                                            function&& fn) {
+  auto found = lower_position(lo);
+  for (leaf_node* leaf = found.first; leaf; leaf = leaf->next_) {
+    for (size_t i = found.second; i < leaf->count_; ++i) {
+      if (!compare_(value_key(leaf->values_[i]), hi)) return;
+      fn(leaf->values_[i]);
+    }
+    found.second = 0;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::erase(
+    iterator pos) {
+  leaf_node* leaf = pos.leaf_;
+  if (!leaf) return;
+  std::destroy_at(leaf->values_ + pos.index_);
+  for (size_t i = pos.index_ + 1; i < leaf->count_; ++i) {
+    relocate(leaf->values_ + i, leaf->values_ + i - 1);
+  }
+  --leaf->count_;
+  --size_;
+  rebalance_leaf(leaf);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename... Args>
+std::pair<
+    typename s21::b_tree<data_type, compare, allocator, key_of,
+                         fanout>::iterator,
+    bool>
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::emplace_hint_value(
+    bool unique, const_iterator hint, Args&&... args) {
+  // значение строится до вставки: сдвиги в листе не должны прерываться
+  // исключением из конструктора
+  data_type value(std::forward<Args>(args)...);
+  insert_position position = find_hint_position(hint, value_key(value), unique);
+  if (position.existing_) {
+    return {iterator(position.leaf_, position.index_, this), false};
+  }
+  return {insert_at(position, std::move(value)), true};
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename input_iterator>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::assign_range(
+    input_iterator first, input_iterator last, bool unique) {
+  clear();
+  // отсортированный вход целиком идёт через дозапись в последний лист
+  for (; first != last; ++first) {
+    emplace_hint_value(unique, cend(), *first);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::merge_values(
+    b_tree& other, bool unique) {
+  if (this == &other) return;
+  // значения переезжают по одному; не вставленные дубликаты собираются в
+  // новое дерево, которое заменит other
+  b_tree rest(other.alloc_);
+  rest.compare_ = other.compare_;
+  for (data_type& value : other) {
+    insert_position position = find_insert_position(value_key(value), unique);
+    if (position.existing_) {
+      rest.emplace_hint_value(unique, rest.cend(), std::move(value));
+    } else {
+      insert_at(position, std::move(value));
+    }
+  }
+  other = std::move(rest);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+typename s21::b_tree<data_type, compare, allocator, key_of,
+                     fanout>::insert_position
+s21::b_tree<data_type, compare, allocator, key_of,
+            fanout>::find_insert_position(const other_key& key,
+                                          bool unique) const {
+  if (!root_) return {nullptr, 0, false};
+  const node* current = root_;
+  while (!current->leaf_) {
+    const inner_node* inner = static_cast<const inner_node*>(current);
+    current = inner->children_[unique ? lower_child(inner, key)
+                                      : upper_child(inner, key)];
+  }
+  leaf_node* leaf = const_cast<leaf_node*>(static_cast<const leaf_node*>(
+      current));
+  if (!unique) return {leaf, upper_index(leaf, key), false};
+  size_t index = lower_index(leaf, key);
+  if (index < leaf->count_) {
+    bool existing = !compare_(key, value_key(leaf->values_[index]));
+    return {leaf, index, existing};
+  }
+  // равный ключ может открывать следующий лист
+  if (leaf->next_ && !compare_(key, value_key(leaf->next_->values_[0]))) {
+    return {leaf->next_, 0, true};
+  }
+  return {leaf, index, false};
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+typename s21::b_tree<data_type, compare, allocator, key_of,
+                     fanout>::insert_position
+s21::b_tree<data_type, compare, allocator, key_of,
+            fanout>::find_hint_position(const_iterator hint,
+                                        const other_key& key,
+                                        bool unique) const {
+  // вставка за максимумом по подсказке end() идёт сразу в последний лист
+  if (hint.tree_ == this && !hint.leaf_ && last_) {
+    const key_type& max_key = value_key(last_->values_[last_->count_ - 1]);
+    if (unique ? compare_(max_key, key) : !compare_(key, max_key)) {
+      return {last_, last_->count_, false};
+    }
+  }
+  return find_insert_position(key, unique);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::iterator
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::insert_at(
+    insert_position position, data_type&& value) {
+  if (!root_) {
+    root_ = first_ = last_ = create_leaf();
+    position = {last_, 0, false};
+  }
+  leaf_node* leaf = position.leaf_;
+  size_t index = position.index_;
+  if (leaf->count_ == fanout) {
+    return insert_split(leaf, index, std::move(value));
+  }
+  place_value(leaf, index, std::move(value));
+  return iterator(leaf, index, this);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::iterator
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::insert_split(
+    leaf_node* leaf, size_t index, data_type&& value) {
+  // дозапись в конец дерева оставляет левый лист полным, как при
+  // построении из отсортированных данных
+  bool append = leaf == last_ && index == fanout;
+  size_t keep = append ? fanout : fanout / 2;
+  // копия разделителя и все узлы, которые понадобятся делению, готовятся
+  // до первого изменения дерева: при исключении оно остаётся прежним, а
+  // value не тронуто
+  key_type separator(value_key(index == keep ? value : leaf->values_[keep]));
+  inner_node* spare = reserve_inners(leaf->parent_);
+  leaf_node* right;
+  try {
+    right = create_leaf();
+  } catch (...) {
+    release_inners(spare);
+    throw;
+  }
+  split_leaf(leaf, keep, right);
+  leaf_node* target = leaf;
+  if (index >= keep) {
+    index -= keep;
+    target = right;
+  }
+  place_value(target, index, std::move(value));
+  insert_child(leaf->parent_, leaf, std::move(separator), right, spare);
+  return iterator(target, index, this);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::place_value(
+    leaf_node* leaf, size_t index, data_type&& value) {
+  for (size_t i = leaf->count_; i > index; --i) {
+    relocate(leaf->values_ + i - 1, leaf->values_ + i);
+  }
+  construct_at(leaf->values_ + index, std::move(value));
+  ++leaf->count_;
+  ++size_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+std::pair<typename s21::b_tree<data_type, compare, allocator, key_of,
+                               fanout>::leaf_node*,
+          size_t>
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::lower_position(
+    const other_key& key) const {
+  if (!root_) return {nullptr, 0};
+  const node* current = root_;
+  while (!current->leaf_) {
+    const inner_node* inner = static_cast<const inner_node*>(current);
+    current = inner->children_[lower_child(inner, key)];
+  }
+  leaf_node* leaf = const_cast<leaf_node*>(static_cast<const leaf_node*>(
+      current));
+  size_t index = lower_index(leaf, key);
+  if (index == leaf->count_) return {leaf->next_, 0};
+  return {leaf, index};
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+std::pair<typename s21::b_tree<data_type, compare, allocator, key_of,
+                               fanout>::leaf_node*,
+          size_t>
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::upper_position(
+    const other_key& key) const {
+  if (!root_) return {nullptr, 0};
+  const node* current = root_;
+  while (!current->leaf_) {
+    const inner_node* inner = static_cast<const inner_node*>(current);
+    current = inner->children_[upper_child(inner, key)];
+  }
+  leaf_node* leaf = const_cast<leaf_node*>(static_cast<const leaf_node*>(
+      current));
+  size_t index = upper_index(leaf, key);
+  if (index == leaf->count_) return {leaf->next_, 0};
+  return {leaf, index};
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+size_t s21::b_tree<data_type, compare, allocator, key_of, fanout>::lower_index(
+    const leaf_node* leaf, const other_key& key) const {
+  return std::lower_bound(leaf->values_, leaf->values_ + leaf->count_, key,
+                          [this](const data_type& value, const other_key& k) {
+                            return compare_(value_key(value), k);
+                          }) -
+         leaf->values_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+template <typename other_key>
+size_t s21::b_tree<data_type, compare, allocator, key_of, fanout>::upper_index(
+    const leaf_node* leaf, const other_key& key) const {
+  return std::upper_bound(leaf->values_, leaf->values_ + leaf->count_, key,
+                          [this](const other_key& k, const data_type& value) {
+                            return compare_(k, value_key(value));
+                          }) -
+         leaf->values_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+size_t s21::b_tree<data_type, compare, allocator, key_of, fanout>::child_index(
+    const inner_node* parent, const node* child) {
+  size_t index = 0;
+  while (parent->children_[index] != child) ++index;
+  return index;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::leaf_node*
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::create_leaf() {
+  leaf_allocator leaves(alloc_);
+  leaf_node* leaf = std::allocator_traits<leaf_allocator>::allocate(leaves, 1);
+  ::new (static_cast<void*>(leaf)) leaf_node();
+  return leaf;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::inner_node*
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::create_inner() {
+  inner_allocator inners(alloc_);
+  inner_node* inner =
+      std::allocator_traits<inner_allocator>::allocate(inners, 1);
+  ::new (static_cast<void*>(inner)) inner_node();
+  return inner;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::destroy_leaf(
+    leaf_node* leaf) noexcept {
+  leaf->~leaf_node();
+  leaf_allocator leaves(alloc_);
+  std::allocator_traits<leaf_allocator>::deallocate(leaves, leaf, 1);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::destroy_inner(
+    inner_node* inner) noexcept {
+  inner->~inner_node();
+  inner_allocator inners(alloc_);
+  std::allocator_traits<inner_allocator>::deallocate(inners, inner, 1);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of,
+                 fanout>::destroy_subtree(node* node_curr) noexcept {
+  if (!node_curr) return;
+  if (node_curr->leaf_) {
+    leaf_node* leaf = static_cast<leaf_node*>(node_curr);
+    std::destroy(leaf->values_, leaf->values_ + leaf->count_);
+    destroy_leaf(leaf);
+  } else {
+    inner_node* inner = static_cast<inner_node*>(node_curr);
+    for (size_t i = 0; i < inner->count_; ++i) {
+      destroy_subtree(inner->children_[i]);
+    }
+    if (inner->count_ > 0) {
+      std::destroy(inner->keys_, inner->keys_ + inner->count_ - 1);
+    }
+    destroy_inner(inner);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::node*
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::copy_subtree(
+    const node* src, inner_node* parent) {
+  if (!src) return nullptr;
+  if (src->leaf_) {
+    const leaf_node* src_leaf = static_cast<const leaf_node*>(src);
+    leaf_node* leaf = create_leaf();
+    leaf->parent_ = parent;
+    leaf->prev_ = last_;
+    if (last_) {
+      last_->next_ = leaf;
+    } else {
+      first_ = leaf;
+    }
+    last_ = leaf;
+    try {
+      for (; leaf->count_ < src_leaf->count_; ++leaf->count_) {
+        construct_at(leaf->values_ + leaf->count_,
+                     src_leaf->values_[leaf->count_]);
+      }
+    } catch (...) {
+      destroy_subtree(leaf);
+      throw;
+    }
+    return leaf;
+  }
+  const inner_node* src_inner = static_cast<const inner_node*>(src);
+  inner_node* inner = create_inner();
+  inner->parent_ = parent;
+  // ключ считается построенным только вместе с правым потомком, поэтому при
+  // исключении destroy_subtree видит согласованный узел
+  try {
+    inner->children_[0] = copy_subtree(src_inner->children_[0], inner);
+    inner->count_ = 1;
+    for (size_t i = 1; i < src_inner->count_; ++i) {
+      construct_at(inner->keys_ + i - 1, src_inner->keys_[i - 1]);
+      try {
+        inner->children_[i] = copy_subtree(src_inner->children_[i], inner);
+      } catch (...) {
+        std::destroy_at(inner->keys_ + i - 1);
+        throw;
+      }
+      ++inner->count_;
+    }
+  } catch (...) {
+    destroy_subtree(inner);
+    throw;
+  }
+  return inner;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::inner_node*
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::reserve_inners(
+    inner_node* parent) {
+  // по узлу на каждого полного предка и ещё один под новый корень, если
+  // полны все; запас связан через parent_
+  inner_node* spare = nullptr;
+  try {
+    for (inner_node* inner = parent;; inner = inner->parent_) {
+      if (inner && inner->count_ < fanout) break;
+      inner_node* extra = create_inner();
+      extra->parent_ = spare;
+      spare = extra;
+      if (!inner) break;
+    }
+  } catch (...) {
+    release_inners(spare);
+    throw;
+  }
+  return spare;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+typename s21::b_tree<data_type, compare, allocator, key_of, fanout>::inner_node*
+s21::b_tree<data_type, compare, allocator, key_of, fanout>::take_inner(
+    inner_node*& spare) noexcept {
+  inner_node* inner = spare;
+  spare = inner->parent_;
+  inner->parent_ = nullptr;
+  return inner;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of,
+                 fanout>::release_inners(inner_node* spare) noexcept {
+  while (spare) destroy_inner(take_inner(spare));
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::split_leaf(
+    leaf_node* leaf, size_t keep, leaf_node* right) {
+  right->parent_ = leaf->parent_;
+  for (size_t i = keep; i < leaf->count_; ++i) {
+    relocate(leaf->values_ + i, right->values_ + i - keep);
+  }
+  right->count_ = leaf->count_ - keep;
+  leaf->count_ = keep;
+  right->prev_ = leaf;
+  right->next_ = leaf->next_;
+  if (leaf->next_) {
+    leaf->next_->prev_ = right;
+  } else {
+    last_ = right;
+  }
+  leaf->next_ = right;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::insert_child(
+    inner_node* parent, node* left, key_type&& separator, node* right,
+    inner_node*& spare) {
+  if (!parent) {
+    inner_node* root = take_inner(spare);
+    construct_at(root->keys_, std::move(separator));
+    root->children_[0] = left;
+    root->children_[1] = right;
+    root->count_ = 2;
+    left->parent_ = right->parent_ = root;
+    root_ = root;
+    return;
+  }
+  size_t pos = child_index(parent, left);
+  if (parent->count_ < fanout) {
+    insert_into(parent, pos, std::move(separator), right);
+    return;
+  }
+  // полный узел делится пополам, средний ключ поднимается к родителю
+  inner_node* sibling = take_inner(spare);
+  size_t keep = fanout / 2;
+  key_type middle(std::move(parent->keys_[keep - 1]));
+  std::destroy_at(parent->keys_ + keep - 1);
+  for (size_t i = keep; i < fanout; ++i) {
+    sibling->children_[i - keep] = parent->children_[i];
+    sibling->children_[i - keep]->parent_ = sibling;
+    if (i + 1 < fanout) {
+      relocate(parent->keys_ + i, sibling->keys_ + i - keep);
+    }
+  }
+  sibling->count_ = fanout - keep;
+  parent->count_ = keep;
+  if (pos >= keep) {
+    insert_into(sibling, pos - keep, std::move(separator), right);
+  } else {
+    insert_into(parent, pos, std::move(separator), right);
+  }
+  insert_child(parent->parent_, parent, std::move(middle), sibling, spare);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::insert_into(
+    inner_node* inner, size_t pos, key_type&& separator, node* right) {
+  for (size_t i = inner->count_ - 1; i > pos; --i) {
+    relocate(inner->keys_ + i - 1, inner->keys_ + i);
+    inner->children_[i + 1] = inner->children_[i];
+  }
+  construct_at(inner->keys_ + pos, std::move(separator));
+  inner->children_[pos + 1] = right;
+  right->parent_ = inner;
+  ++inner->count_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::remove_child(
+    inner_node* inner, size_t key_index) noexcept {
+  // удаляются разделитель key_index и потомок справа от него
+  std::destroy_at(inner->keys_ + key_index);
+  for (size_t i = key_index + 1; i + 1 < inner->count_; ++i) {
+    relocate(inner->keys_ + i, inner->keys_ + i - 1);
+    inner->children_[i] = inner->children_[i + 1];
+  }
+  --inner->count_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::rebalance_leaf(
+    leaf_node* leaf) {
+  if (leaf == root_) {
+    if (leaf->count_ == 0) {
+      destroy_leaf(leaf);
+      root_ = first_ = last_ = nullptr;
+    }
+    return;
+  }
+  if (leaf->count_ >= fanout / 2) return;
+  // недозаполненный лист сливается с соседом или забирает у него значение
+  inner_node* parent = leaf->parent_;
+  size_t pos = child_index(parent, leaf);
+  if (pos > 0) {
+    leaf_node* left = static_cast<leaf_node*>(parent->children_[pos - 1]);
+    if (left->count_ + leaf->count_ <= fanout) {
+      merge_leaves(left, leaf, pos - 1);
+      return;
+    }
+    for (size_t i = leaf->count_; i > 0; --i) {
+      relocate(leaf->values_ + i - 1, leaf->values_ + i);
+    }
+    relocate(left->values_ + left->count_ - 1, leaf->values_);
+    --left->count_;
+    ++leaf->count_;
+    parent->keys_[pos - 1] = value_key(leaf->values_[0]);
+  } else {
+    leaf_node* right = static_cast<leaf_node*>(parent->children_[1]);
+    if (leaf->count_ + right->count_ <= fanout) {
+      merge_leaves(leaf, right, 0);
+      return;
+    }
+    relocate(right->values_, leaf->values_ + leaf->count_);
+    for (size_t i = 1; i < right->count_; ++i) {
+      relocate(right->values_ + i, right->values_ + i - 1);
+    }
+    --right->count_;
+    ++leaf->count_;
+    parent->keys_[0] = value_key(right->values_[0]);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::merge_leaves(
+    leaf_node* left, leaf_node* right, size_t key_index) {
+  for (size_t i = 0; i < right->count_; ++i) {
+    relocate(right->values_ + i, left->values_ + left->count_ + i);
+  }
+  left->count_ += right->count_;
+  left->next_ = right->next_;
+  if (right->next_) {
+    right->next_->prev_ = left;
+  } else {
+    last_ = left;
+  }
+  inner_node* parent = left->parent_;
+  destroy_leaf(right);
+  remove_child(parent, key_index);
+  rebalance_inner(parent);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of,
+                 fanout>::rebalance_inner(inner_node* inner) {
+  if (inner == root_) {
+    // корень с одним потомком уступает ему место
+    if (inner->count_ == 1) {
+      root_ = inner->children_[0];
+      root_->parent_ = nullptr;
+      destroy_inner(inner);
+    }
+    return;
+  }
+  if (inner->count_ >= fanout / 2) return;
+  inner_node* parent = inner->parent_;
+  size_t pos = child_index(parent, inner);
+  if (pos > 0) {
+    inner_node* left = static_cast<inner_node*>(parent->children_[pos - 1]);
+    if (left->count_ + inner->count_ <= fanout) {
+      merge_inners(left, inner, pos - 1);
+      return;
+    }
+    // последний потомок left переходит в начало inner через родителя
+    for (size_t i = inner->count_; i > 0; --i) {
+      if (i > 1) relocate(inner->keys_ + i - 2, inner->keys_ + i - 1);
+      inner->children_[i] = inner->children_[i - 1];
+    }
+    construct_at(inner->keys_, std::move(parent->keys_[pos - 1]));
+    inner->children_[0] = left->children_[left->count_ - 1];
+    inner->children_[0]->parent_ = inner;
+    parent->keys_[pos - 1] = std::move(left->keys_[left->count_ - 2]);
+    std::destroy_at(left->keys_ + left->count_ - 2);
+    --left->count_;
+    ++inner->count_;
+  } else {
+    inner_node* right = static_cast<inner_node*>(parent->children_[1]);
+    if (inner->count_ + right->count_ <= fanout) {
+      merge_inners(inner, right, 0);
+      return;
+    }
+    construct_at(inner->keys_ + inner->count_ - 1,
+                 std::move(parent->keys_[0]));
+    inner->children_[inner->count_] = right->children_[0];
+    inner->children_[inner->count_]->parent_ = inner;
+    parent->keys_[0] = std::move(right->keys_[0]);
+    std::destroy_at(right->keys_);
+    for (size_t i = 1; i < right->count_; ++i) {
+      if (i + 1 < right->count_) {
+        relocate(right->keys_ + i, right->keys_ + i - 1);
+      }
+      right->children_[i - 1] = right->children_[i];
+    }
+    --right->count_;
+    ++inner->count_;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, size_t fanout>
+void s21::b_tree<data_type, compare, allocator, key_of, fanout>::merge_inners(
+    inner_node* left, inner_node* right, size_t key_index) {
+  inner_node* parent = left->parent_;
+  construct_at(left->keys_ + left->count_ - 1,
+               std::move(parent->keys_[key_index]));
+  for (size_t i = 0; i < right->count_; ++i) {
+    if (i + 1 < right->count_) {
+      relocate(right->keys_ + i, left->keys_ + left->count_ + i);
+    }
+    left->children_[left->count_ + i] = right->children_[i];
+    right->children_[i]->parent_ = left;
+  }
+  left->count_ += right->count_;
+  destroy_inner(right);
+  remove_child(parent, key_index);
+  rebalance_inner(parent);
+}
+
+#endif
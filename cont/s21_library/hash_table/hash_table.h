@@ -0,0 +1,550 @@
+#ifndef S21_HASH_TABLE
+#define S21_HASH_TABLE
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+
+// Группа из 16 управляющих байтов. Каждый байт описывает один слот:
+// empty и deleted отрицательны, у занятого слота там лежат младшие 7 бит
+// хеша (h2). Сравнение с h2 сразу для 16 слотов даёт битовую маску
+// кандидатов, и ключи сравниваются только у них.
+struct control_group {
+  static constexpr size_t width = 16;
+  static constexpr int8_t empty = -128;
+  static constexpr int8_t deleted = -2;
+
+#ifdef __SSE2__
+  explicit control_group(const int8_t* ctrl)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+  uint32_t match(int8_t h2) const {
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+  }
+  uint32_t match_empty() const { return match(empty); }
+  // у empty и deleted установлен знаковый бит
+  uint32_t match_empty_or_deleted() const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+  }
+
+ private:
+  __m128i ctrl_;
+#else
+  // переносимый вариант для платформ без SSE2 с теми же масками
+  explicit control_group(const int8_t* ctrl) {
+    std::memcpy(ctrl_, ctrl, width);
+  }
+  uint32_t match(int8_t h2) const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < width; ++i) {
+      if (ctrl_[i] == h2) mask |= uint32_t(1) << i;
+    }
+    return mask;
+  }
+  uint32_t match_empty() const { return match(empty); }
+  uint32_t match_empty_or_deleted() const {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < width; ++i) {
+      if (ctrl_[i] < 0) mask |= uint32_t(1) << i;
+    }
+    return mask;
+  }
+
+ private:
+  int8_t ctrl_[width];
+#endif
+};
+
+// Таблица с открытой адресацией: значения лежат прямо в массиве слотов,
+// рядом хранится массив управляющих байтов. Поиск проходит группы по 16
+// слотов по треугольной последовательности, поэтому обычно хватает одного
+// чтения управляющих байтов и одного обращения к слоту. Заполненность не
+// превышает 7/8. Вставка с перестройкой таблицы делает итераторы
+// недействительными.
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+class hash_table {
+ public:
+  using key_type =
+      std::decay_t<std::invoke_result_t<key_of, const data_type&>>;
+  class iterator;
+  class const_iterator;
+
+  hash_table()
+      : ctrl_(nullptr), slots_(nullptr), capacity_(0), size_(0),
+        growth_left_(0) {}
+  explicit hash_table(const allocator& alloc) : hash_table() {
+    alloc_ = alloc;
+  }
+  hash_table(const hash_table& other);
+  hash_table(hash_table&& other) noexcept;
+  ~hash_table() { release(); }
+
+  hash_table& operator=(hash_table&& other) noexcept;
+
+  iterator begin() { return iterator(this, skip_empty(0)); }
+  iterator end() { return iterator(this, capacity_); }
+  const_iterator begin() const { return cbegin(); }
+  const_iterator end() const { return cend(); }
+  const_iterator cbegin() const {
+    return const_iterator(this, skip_empty(0));
+  }
+  const_iterator cend() const { return const_iterator(this, capacity_); }
+
+  iterator find(const key_type& key) {
+    return iterator(this, find_index(key, hash_of(key)));
+  }
+  const_iterator find(const key_type& key) const {
+    return const_iterator(this, find_index(key, hash_of(key)));
+  }
+  bool contains(const key_type& key) const {
+    return find_index(key, hash_of(key)) != capacity_;
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  size_t max_size() const noexcept {
+    return std::allocator_traits<allocator>::max_size(alloc_);
+  }
+  size_t bucket_count() const noexcept { return capacity_; }
+  float load_factor() const noexcept {
+    return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f;
+  }
+  allocator get_allocator() const { return alloc_; }
+
+  void clear() noexcept;
+  void erase(iterator pos);
+  size_t erase(const key_type& key);
+  void swap(hash_table& other) noexcept;
+  // rehash(count) перестраивает таблицу минимум на count слотов (и на все
+  // текущие элементы), reserve(count) — так, чтобы count элементов
+  // поместились без перестройки
+  void rehash(size_t count);
+  void reserve(size_t count) {
+    if (count > size_ + growth_left_) rehash(count + count / 7 + 1);
+  }
+
+ protected:
+  int8_t* ctrl_;
+  data_type* slots_;
+  size_t capacity_;
+  size_t size_;
+  size_t growth_left_;
+  hash hash_;
+  key_equal equal_;
+  allocator alloc_;
+
+  using ctrl_allocator =
+      typename std::allocator_traits<allocator>::template rebind_alloc<int8_t>;
+
+  // место для вставки: свободный слот или уже существующий ключ
+  struct insert_position {
+    size_t index_;
+    bool existing_;
+    int8_t h2_;
+  };
+
+  static const key_type& value_key(const data_type& value) {
+    return key_of()(value);
+  }
+  size_t hash_of(const key_type& key) const {
+    // std::hash для целых — тождественная функция; перемешивание поднимает
+    // энтропию в младшие биты, по которым выбирается группа
+    uint64_t mixed =
+        static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(mixed ^ (mixed >> 32));
+  }
+  static int8_t h2_of(size_t hashed) {
+    return static_cast<int8_t>(hashed & 0x7f);
+  }
+
+  size_t find_index(const key_type& key, size_t hashed) const;
+  insert_position find_insert_position(const key_type& key);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_value(Args&&... args);
+  // строит значение прямо в слоте position; вызывается после
+  // find_insert_position, между ними таблица не меняется
+  template <typename... Args>
+  iterator emplace_at(insert_position position, Args&&... args);
+
+  size_t find_free_slot(size_t hashed) const;
+  size_t skip_empty(size_t index) const {
+    while (index < capacity_ && ctrl_[index] < 0) ++index;
+    return index;
+  }
+  void set_ctrl(size_t index, int8_t value) {
+    ctrl_[index] = value;
+    // первые width - 1 байтов повторяются за концом массива, чтобы группа
+    // читалась одним загрузочным словом с любого слота
+    if (index < control_group::width - 1) ctrl_[capacity_ + index] = value;
+  }
+  void allocate(size_t capacity);
+  void release() noexcept;
+  void resize(size_t capacity);
+  static size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+};
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+class hash_table<data_type, hash, key_equal, allocator, key_of>::iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = data_type*;
+  using reference = data_type&;
+
+  iterator() : table_(nullptr), index_(0) {}
+  iterator(hash_table* table, size_t index) : table_(table), index_(index) {}
+
+  data_type& operator*() const { return table_->slots_[index_]; }
+  data_type* operator->() const { return table_->slots_ + index_; }
+  iterator& operator++() {
+    index_ = table_->skip_empty(index_ + 1);
+    return *this;
+  }
+  iterator operator++(int) {
+    iterator copy = *this;
+    ++*this;
+    return copy;
+  }
+  bool operator==(const iterator& other) const {
+    return index_ == other.index_;
+  }
+  bool operator!=(const iterator& other) const {
+    return index_ != other.index_;
+  }
+
+ private:
+  friend class hash_table;
+  hash_table* table_;
+  size_t index_;
+};
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+class hash_table<data_type, hash, key_equal, allocator,
+                 key_of>::const_iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const data_type*;
+  using reference = const data_type&;
+
+  const_iterator() : table_(nullptr), index_(0) {}
+  const_iterator(const hash_table* table, size_t index)
+      : table_(table), index_(index) {}
+  const_iterator(const iterator& other)
+      : table_(other.table_), index_(other.index_) {}
+
+  const data_type& operator*() const { return table_->slots_[index_]; }
+  const data_type* operator->() const { return table_->slots_ + index_; }
+  const_iterator& operator++() {
+    index_ = table_->skip_empty(index_ + 1);
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator copy = *this;
+    ++*this;
+    return copy;
+  }
+  bool operator==(const const_iterator& other) const {
+    return index_ == other.index_;
+  }
+  bool operator!=(const const_iterator& other) const {
+    return index_ != other.index_;
+  }
+
+ private:
+  friend class hash_table;
+  const hash_table* table_;
+  size_t index_;
+};
+}  // namespace s21
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>::hash_table(
+    const hash_table& other)
+    : hash_table() {
+  hash_ = other.hash_;
+  equal_ = other.equal_;
+  alloc_ = other.alloc_;
+  if (other.size_ == 0) return;
+  allocate(other.capacity_);
+  // копия повторяет раскладку исходной таблицы слот в слот вместе с
+  // удалёнными слотами, иначе оборвались бы последовательности проб
+  try {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (other.ctrl_[i] >= 0) {
+        ::new (static_cast<void*>(slots_ + i)) data_type(other.slots_[i]);
+        ++size_;
+      }
+      if (other.ctrl_[i] != control_group::empty) set_ctrl(i, other.ctrl_[i]);
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+  growth_left_ = other.growth_left_;
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>::hash_table(
+    hash_table&& other) noexcept
+    : hash_table() {
+  swap(other);
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>&
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>::operator=(
+    hash_table&& other) noexcept {
+  if (this != &other) {
+    release();
+    swap(other);
+  }
+  return *this;
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator,
+                     key_of>::clear() noexcept {
+  // память остаётся за таблицей, как у std::unordered_map после clear()
+  for (size_t i = 0; i < capacity_; ++i) {
+    if (ctrl_[i] >= 0) std::destroy_at(slots_ + i);
+  }
+  if (capacity_) {
+    std::memset(ctrl_, control_group::empty,
+                capacity_ + control_group::width - 1);
+  }
+  size_ = 0;
+  growth_left_ = max_load(capacity_);
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator, key_of>::erase(
+    iterator pos) {
+  size_t index = pos.index_;
+  std::destroy_at(slots_ + index);
+  --size_;
+  // слот можно снова сделать пустым, только если никакое окно из 16 слотов
+  // вокруг него не было заполнено целиком: через такое окно не проходила
+  // ни одна последовательность проб. Иначе остаётся метка deleted
+  size_t before = (index - control_group::width) & (capacity_ - 1);
+  uint32_t empty_after = control_group(ctrl_ + index).match_empty();
+  uint32_t empty_before = control_group(ctrl_ + before).match_empty();
+  if (empty_after && empty_before &&
+      __builtin_ctz(empty_after) + (__builtin_clz(empty_before) - 16) <
+          static_cast<int>(control_group::width)) {
+    set_ctrl(index, control_group::empty);
+    ++growth_left_;
+  } else {
+    set_ctrl(index, control_group::deleted);
+  }
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+size_t s21::hash_table<data_type, hash, key_equal, allocator, key_of>::erase(
+    const key_type& key) {
+  size_t index = find_index(key, hash_of(key));
+  if (index == capacity_) return 0;
+  erase(iterator(this, index));
+  return 1;
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator, key_of>::swap(
+    hash_table& other) noexcept {
+  using std::swap;
+  swap(ctrl_, other.ctrl_);
+  swap(slots_, other.slots_);
+  swap(capacity_, other.capacity_);
+  swap(size_, other.size_);
+  swap(growth_left_, other.growth_left_);
+  swap(hash_, other.hash_);
+  swap(equal_, other.equal_);
+  swap(alloc_, other.alloc_);
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator, key_of>::rehash(
+    size_t count) {
+  size_t needed = size_ + size_ / 7 + 1;
+  if (count < needed) count = needed;
+  size_t capacity = control_group::width;
+  while (capacity < count) capacity *= 2;
+  if (capacity != capacity_ || growth_left_ + size_ < max_load(capacity_)) {
+    resize(capacity);
+  }
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+size_t
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>::find_index(
+    const key_type& key, size_t hashed) const {
+  if (size_ == 0) return capacity_;
+  int8_t h2 = h2_of(hashed);
+  size_t mask = capacity_ - 1;
+  size_t offset = (hashed >> 7) & mask;
+  // треугольная последовательность по группам обходит всю таблицу, так как
+  // capacity_ — степень двойки
+  for (size_t step = control_group::width;; step += control_group::width) {
+    control_group group(ctrl_ + offset);
+    for (uint32_t match = group.match(h2); match; match &= match - 1) {
+      size_t index = (offset + __builtin_ctz(match)) & mask;
+      if (equal_(value_key(slots_[index]), key)) return index;
+    }
+    if (group.match_empty()) return capacity_;
+    offset = (offset + step) & mask;
+  }
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+size_t
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>::find_free_slot(
+    size_t hashed) const {
+  size_t mask = capacity_ - 1;
+  size_t offset = (hashed >> 7) & mask;
+  for (size_t step = control_group::width;; step += control_group::width) {
+    uint32_t match = control_group(ctrl_ + offset).match_empty_or_deleted();
+    if (match) return (offset + __builtin_ctz(match)) & mask;
+    offset = (offset + step) & mask;
+  }
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+typename s21::hash_table<data_type, hash, key_equal, allocator,
+                         key_of>::insert_position
+s21::hash_table<data_type, hash, key_equal, allocator,
+                key_of>::find_insert_position(const key_type& key) {
+  // хеш считается один раз и для поиска, и для выбора свободного слота
+  size_t hashed = hash_of(key);
+  size_t index = find_index(key, hashed);
+  if (index != capacity_) return {index, true, h2_of(hashed)};
+  index = capacity_ ? find_free_slot(hashed) : 0;
+  bool reuse = capacity_ && ctrl_[index] == control_group::deleted;
+  if (capacity_ == 0 || (growth_left_ == 0 && !reuse)) {
+    // при большом числе удалённых слотов таблица перестраивается в том же
+    // размере, иначе вдвое больше
+    rehash(size_ * 2 > max_load(capacity_) ? capacity_ * 2 : capacity_);
+    index = find_free_slot(hashed);
+  }
+  return {index, false, h2_of(hashed)};
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+template <typename... Args>
+std::pair<typename s21::hash_table<data_type, hash, key_equal, allocator,
+                                   key_of>::iterator,
+          bool>
+s21::hash_table<data_type, hash, key_equal, allocator,
+                key_of>::emplace_value(Args&&... args) {
+  // ключ нужен до поиска места, поэтому значение строится заранее
+  data_type value(std::forward<Args>(args)...);
+  insert_position position = find_insert_position(value_key(value));
+  if (position.existing_) return {iterator(this, position.index_), false};
+  return {emplace_at(position, std::move(value)), true};
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+template <typename... Args>
+typename s21::hash_table<data_type, hash, key_equal, allocator,
+                         key_of>::iterator
+s21::hash_table<data_type, hash, key_equal, allocator, key_of>::emplace_at(
+    insert_position position, Args&&... args) {
+  size_t index = position.index_;
+  bool reused = ctrl_[index] == control_group::deleted;
+  ::new (static_cast<void*>(slots_ + index))
+      data_type(std::forward<Args>(args)...);
+  set_ctrl(index, position.h2_);
+  ++size_;
+  if (!reused) --growth_left_;
+  return iterator(this, index);
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator, key_of>::allocate(
+    size_t capacity) {
+  ctrl_allocator ctrl_alloc(alloc_);
+  size_t ctrl_size = capacity + control_group::width - 1;
+  ctrl_ = std::allocator_traits<ctrl_allocator>::allocate(ctrl_alloc,
+                                                          ctrl_size);
+  try {
+    slots_ = std::allocator_traits<allocator>::allocate(alloc_, capacity);
+  } catch (...) {
+    std::allocator_traits<ctrl_allocator>::deallocate(ctrl_alloc, ctrl_,
+                                                      ctrl_size);
+    ctrl_ = nullptr;
+    throw;
+  }
+  std::memset(ctrl_, control_group::empty, ctrl_size);
+  capacity_ = capacity;
+  size_ = 0;
+  growth_left_ = max_load(capacity);
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator,
+                     key_of>::release() noexcept {
+  if (!capacity_) return;
+  clear();
+  ctrl_allocator ctrl_alloc(alloc_);
+  std::allocator_traits<ctrl_allocator>::deallocate(
+      ctrl_alloc, ctrl_, capacity_ + control_group::width - 1);
+  std::allocator_traits<allocator>::deallocate(alloc_, slots_, capacity_);
+  ctrl_ = nullptr;
+  slots_ = nullptr;
+  capacity_ = 0;
+  growth_left_ = 0;
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator, typename key_of>
+void s21::hash_table<data_type, hash, key_equal, allocator, key_of>::resize(
+    size_t capacity) {
+  hash_table fresh(alloc_);
+  fresh.hash_ = hash_;
+  fresh.equal_ = equal_;
+  fresh.allocate(capacity);
+  // значения переносятся в новые слоты без сравнения ключей: все они
+  // заведомо различны
+  for (size_t i = 0; i < capacity_; ++i) {
+    if (ctrl_[i] < 0) continue;
+    size_t hashed = hash_of(value_key(slots_[i]));
+    size_t index = fresh.find_free_slot(hashed);
+    ::new (static_cast<void*>(fresh.slots_ + index))
+        data_type(std::move(slots_[i]));
+    fresh.set_ctrl(index, h2_of(hashed));
+    ++fresh.size_;
+    --fresh.growth_left_;
+  }
+  swap(fresh);
+}
+
+#endif
@@ -0,0 +1,621 @@
+#ifndef S21_PERSISTENT_TREE
+#define S21_PERSISTENT_TREE
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Политика узлов для map: персистентное левостороннее красно-чёрное дерево.
+// Узлы считают ссылки на себя и, пока узел общий для нескольких версий, не
+// меняются. Поэтому копия контейнера и snapshot() стоят O(1) — они только
+// делят корень, — а запись копирует лишь общие узлы на пути от корня к
+// изменяемому месту и правит свои узлы на месте.
+//
+// Правила для потоков: писатель и snapshot() работают в одном потоке (или
+// под общей блокировкой писателя); полученную копию другой поток читает и
+// уничтожает без блокировок, пока писатель продолжает вставки и удаления.
+// Итераторы только константные, любая запись делает их недействительными.
+struct persistent_nodes {};
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+class persistent_tree {
+ protected:
+  struct node;
+
+ public:
+  using key_type =
+      std::decay_t<std::invoke_result_t<key_of, const data_type&>>;
+  class const_iterator;
+  using iterator = const_iterator;
+
+  persistent_tree() : root_(nullptr), size_(0) {}
+  explicit persistent_tree(const allocator& alloc)
+      : root_(nullptr), size_(0), alloc_(alloc) {}
+  // копия делит все узлы с оригиналом
+  persistent_tree(const persistent_tree& other) noexcept
+      : root_(acquire(other.root_)),
+        size_(other.size_),
+        compare_(other.compare_),
+        alloc_(other.alloc_) {}
+  persistent_tree(persistent_tree&& other) noexcept
+      : root_(other.root_),
+        size_(other.size_),
+        compare_(std::move(other.compare_)),
+        alloc_(std::move(other.alloc_)) {
+    other.root_ = nullptr;
+    other.size_ = 0;
+  }
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  persistent_tree(input_iterator first, input_iterator last)
+      : persistent_tree() {
+    for (; first != last; ++first) insert_value(*first);
+  }
+  ~persistent_tree() { clear(); }
+
+  persistent_tree& operator=(const persistent_tree& other) noexcept {
+    persistent_tree copy(other);
+    swap(copy);
+    return *this;
+  }
+  persistent_tree& operator=(persistent_tree&& other) noexcept {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  const_iterator begin() const;
+  const_iterator end() const { return const_iterator(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  template <typename other_key>
+  const_iterator find(const other_key& key) const;
+  template <typename other_key>
+  const_iterator lower_bound(const other_key& key) const;
+  template <typename other_key>
+  const_iterator upper_bound(const other_key& key) const;
+  template <typename other_key>
+  bool contains(const other_key& key) const {
+    return find_node(key) != nullptr;
+  }
+
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  size_t max_size() const noexcept {
+    return std::allocator_traits<node_allocator>::max_size(
+        node_allocator(alloc_));
+  }
+  allocator get_allocator() const { return alloc_; }
+
+  void clear() noexcept {
+    release(root_);
+    root_ = nullptr;
+    size_ = 0;
+  }
+  size_t erase(const key_type& key);
+  void swap(persistent_tree& other) noexcept {
+    using std::swap;
+    swap(root_, other.root_);
+    swap(size_, other.size_);
+    swap(compare_, other.compare_);
+    swap(alloc_, other.alloc_);
+  }
+
+  bool is_balanced() const {
+    int height = 0;
+    return is_balanced(root_, height);
+  }
+
+ protected:
+  // цвет хранится в родителе как цвет ссылки на потомка: перекраска узла
+  // тогда меняет только его самого, а не обоих потомков
+  struct node {
+    data_type data_;
+    node* left_ = nullptr;
+    node* right_ = nullptr;
+    std::atomic<size_t> refs_{1};
+    bool left_red_ = false;
+    bool right_red_ = false;
+    template <typename... Args>
+    explicit node(Args&&... args) : data_(std::forward<Args>(args)...) {}
+  };
+  using node_allocator =
+      typename std::allocator_traits<allocator>::template rebind_alloc<node>;
+
+  node* root_;
+  size_t size_;
+  compare compare_;
+  allocator alloc_;
+
+  static const key_type& node_key(const node* node_curr) {
+    return key_of()(node_curr->data_);
+  }
+  template <typename other_key>
+  node* find_node(const other_key& key) const;
+
+  // Запись идёт в два шага. Сначала unique_path копирует общие узлы на
+  // пути к ключу: каждая копия сразу подменяет оригинал в родителе, так
+  // что исключение посреди пути оставляет дерево тем же. Затем insert_leaf
+  // или erase_node перестраивают уже собственные узлы без выделения памяти.
+  template <typename other_key>
+  node* unique_path(const other_key& key);
+  void unique_erase_path(const key_type& key);
+  // ключ нового узла ещё не в дереве, путь к нему уже собственный
+  template <typename... Args>
+  node* insert_leaf(Args&&... args);
+  template <typename value_arg>
+  void insert_value(value_arg&& value) {
+    if (!find_node(key_of()(value))) {
+      unique_path(key_of()(value));
+      insert_leaf(std::forward<value_arg>(value));
+    }
+  }
+
+  template <typename... Args>
+  node* create_node(Args&&... args);
+  void destroy_node(node* node_curr) noexcept;
+  static node* acquire(node* node_curr) noexcept {
+    if (node_curr) node_curr->refs_.fetch_add(1, std::memory_order_relaxed);
+    return node_curr;
+  }
+  void release(node* node_curr) noexcept;
+  void make_unique(node*& slot);
+
+  void link_node(node*& slot, bool& slot_red, node* leaf);
+  void erase_node(node*& slot, bool& slot_red, const key_type& key);
+  node* detach_min(node*& slot, bool& slot_red);
+  void balance(node*& slot, bool& slot_red);
+  void rotate_left(node*& slot);
+  void rotate_right(node*& slot);
+  static void flip_colors(node* node_curr, bool& slot_red) noexcept {
+    node_curr->left_red_ = !node_curr->left_red_;
+    node_curr->right_red_ = !node_curr->right_red_;
+    slot_red = !slot_red;
+  }
+  void move_red_left(node*& slot, bool& slot_red);
+  void move_red_right(node*& slot, bool& slot_red);
+  bool equal_keys(const key_type& left, const key_type& right) const {
+    return !compare_(left, right) && !compare_(right, left);
+  }
+  static bool is_balanced(const node* node_curr, int& black_height);
+};
+
+// Итератор хранит стек узлов, в левых поддеревьях которых он находится:
+// у узлов нет ссылок на родителя, потому что один узел может входить в
+// несколько версий дерева.
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+class persistent_tree<data_type, compare, allocator, key_of>::const_iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const data_type*;
+  using reference = const data_type&;
+
+  const_iterator() = default;
+
+  const data_type& operator*() const { return stack_.back()->data_; }
+  const data_type* operator->() const { return &stack_.back()->data_; }
+  const_iterator& operator++() {
+    const node* node_curr = stack_.back()->right_;
+    stack_.pop_back();
+    push_left(node_curr);
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator copy = *this;
+    ++*this;
+    return copy;
+  }
+  bool operator==(const const_iterator& other) const {
+    return current() == other.current();
+  }
+  bool operator!=(const const_iterator& other) const {
+    return current() != other.current();
+  }
+
+ private:
+  friend class persistent_tree;
+  std::vector<const node*> stack_;
+
+  const node* current() const {
+    return stack_.empty() ? nullptr : stack_.back();
+  }
+  void push_left(const node* node_curr) {
+    for (; node_curr; node_curr = node_curr->left_) stack_.push_back(node_curr);
+  }
+};
+}  // namespace s21
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+typename s21::persistent_tree<data_type, compare, allocator,
+                              key_of>::const_iterator
+s21::persistent_tree<data_type, compare, allocator, key_of>::begin() const {
+  const_iterator it;
+  it.push_left(root_);
+  return it;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename other_key>
+typename s21::persistent_tree<data_type, compare, allocator,
+                              key_of>::const_iterator
+s21::persistent_tree<data_type, compare, allocator, key_of>::find(
+    const other_key& key) const {
+  const_iterator it = lower_bound(key);
+  if (it != end() && compare_(key, node_key(it.stack_.back()))) return end();
+  return it;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename other_key>
+typename s21::persistent_tree<data_type, compare, allocator,
+                              key_of>::const_iterator
+s21::persistent_tree<data_type, compare, allocator, key_of>::lower_bound(
+    const other_key& key) const {
+  // в стеке остаются узлы, от которых спуск ушёл влево: это следующие
+  // по порядку элементы
+  const_iterator it;
+  for (const node* node_curr = root_; node_curr;) {
+    if (compare_(node_key(node_curr), key)) {
+      node_curr = node_curr->right_;
+    } else {
+      it.stack_.push_back(node_curr);
+      node_curr = node_curr->left_;
+    }
+  }
+  return it;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename other_key>
+typename s21::persistent_tree<data_type, compare, allocator,
+                              key_of>::const_iterator
+s21::persistent_tree<data_type, compare, allocator, key_of>::upper_bound(
+    const other_key& key) const {
+  const_iterator it;
+  for (const node* node_curr = root_; node_curr;) {
+    if (compare_(key, node_key(node_curr))) {
+      it.stack_.push_back(node_curr);
+      node_curr = node_curr->left_;
+    } else {
+      node_curr = node_curr->right_;
+    }
+  }
+  return it;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename other_key>
+typename s21::persistent_tree<data_type, compare, allocator, key_of>::node*
+s21::persistent_tree<data_type, compare, allocator, key_of>::find_node(
+    const other_key& key) const {
+  node* node_curr = root_;
+  while (node_curr) {
+    if (compare_(key, node_key(node_curr))) {
+      node_curr = node_curr->left_;
+    } else if (compare_(node_key(node_curr), key)) {
+      node_curr = node_curr->right_;
+    } else {
+      return node_curr;
+    }
+  }
+  return nullptr;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+size_t s21::persistent_tree<data_type, compare, allocator, key_of>::erase(
+    const key_type& key) {
+  if (!find_node(key)) return 0;
+  unique_erase_path(key);
+  // корень временно считается красным, если оба его потомка чёрные, как
+  // при спуске в move_red_left; после удаления цвет корня не важен
+  bool root_red = !root_->left_red_ && !root_->right_red_;
+  erase_node(root_, root_red, key);
+  --size_;
+  return 1;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename other_key>
+typename s21::persistent_tree<data_type, compare, allocator, key_of>::node*
+s21::persistent_tree<data_type, compare, allocator, key_of>::unique_path(
+    const other_key& key) {
+  node** slot = &root_;
+  while (*slot) {
+    make_unique(*slot);
+    node* node_curr = *slot;
+    if (compare_(key, node_key(node_curr))) {
+      slot = &node_curr->left_;
+    } else if (compare_(node_key(node_curr), key)) {
+      slot = &node_curr->right_;
+    } else {
+      return node_curr;
+    }
+  }
+  return nullptr;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator,
+                          key_of>::unique_erase_path(const key_type& key) {
+  // при удалении повороты и перекраски на спуске затрагивают брата узла
+  // пути и внутреннего внука; путь идёт до ключа и дальше до его
+  // преемника
+  make_unique(root_);
+  bool found = false;
+  for (node* node_curr = root_; node_curr;) {
+    if (node_curr->left_) {
+      make_unique(node_curr->left_);
+      if (node_curr->left_->right_) make_unique(node_curr->left_->right_);
+    }
+    if (node_curr->right_) {
+      make_unique(node_curr->right_);
+      if (node_curr->right_->left_) make_unique(node_curr->right_->left_);
+    }
+    if (found || compare_(key, node_key(node_curr))) {
+      node_curr = node_curr->left_;
+    } else if (compare_(node_key(node_curr), key)) {
+      node_curr = node_curr->right_;
+    } else {
+      found = true;
+      node_curr = node_curr->right_;
+    }
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename... Args>
+typename s21::persistent_tree<data_type, compare, allocator, key_of>::node*
+s21::persistent_tree<data_type, compare, allocator, key_of>::insert_leaf(
+    Args&&... args) {
+  node* leaf = create_node(std::forward<Args>(args)...);
+  bool root_red = false;
+  link_node(root_, root_red, leaf);
+  ++size_;
+  return leaf;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+template <typename... Args>
+typename s21::persistent_tree<data_type, compare, allocator, key_of>::node*
+s21::persistent_tree<data_type, compare, allocator, key_of>::create_node(
+    Args&&... args) {
+  node_allocator nodes(alloc_);
+  node* new_node = std::allocator_traits<node_allocator>::allocate(nodes, 1);
+  try {
+    ::new (static_cast<void*>(new_node)) node(std::forward<Args>(args)...);
+  } catch (...) {
+    std::allocator_traits<node_allocator>::deallocate(nodes, new_node, 1);
+    throw;
+  }
+  return new_node;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator,
+                          key_of>::destroy_node(node* node_curr) noexcept {
+  node_allocator nodes(alloc_);
+  node_curr->~node();
+  std::allocator_traits<node_allocator>::deallocate(nodes, node_curr, 1);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::release(
+    node* node_curr) noexcept {
+  // последняя ссылка может уйти из потока читателя: acq_rel упорядочивает
+  // его чтения перед разрушением узла
+  if (node_curr &&
+      node_curr->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    release(node_curr->left_);
+    release(node_curr->right_);
+    destroy_node(node_curr);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::make_unique(
+    node*& slot) {
+  node* shared = slot;
+  if (shared->refs_.load(std::memory_order_acquire) == 1) return;
+  node* copy = create_node(shared->data_);
+  copy->left_ = acquire(shared->left_);
+  copy->right_ = acquire(shared->right_);
+  copy->left_red_ = shared->left_red_;
+  copy->right_red_ = shared->right_red_;
+  slot = copy;
+  release(shared);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::link_node(
+    node*& slot, bool& slot_red, node* leaf) {
+  if (!slot) {
+    slot = leaf;
+    slot_red = true;
+    return;
+  }
+  make_unique(slot);
+  node* node_curr = slot;
+  if (compare_(node_key(leaf), node_key(node_curr))) {
+    link_node(node_curr->left_, node_curr->left_red_, leaf);
+  } else {
+    link_node(node_curr->right_, node_curr->right_red_, leaf);
+  }
+  balance(slot, slot_red);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::erase_node(
+    node*& slot, bool& slot_red, const key_type& key) {
+  make_unique(slot);
+  if (compare_(key, node_key(slot))) {
+    if (!slot->left_red_ && !slot->left_->left_red_) {
+      move_red_left(slot, slot_red);
+    }
+    erase_node(slot->left_, slot->left_red_, key);
+  } else {
+    if (slot->left_red_) rotate_right(slot);
+    node* node_curr = slot;
+    if (!node_curr->right_ && equal_keys(key, node_key(node_curr))) {
+      // в левостороннем дереве у такого узла нет и левого потомка
+      slot = nullptr;
+      slot_red = false;
+      release(node_curr);
+      return;
+    }
+    if (!node_curr->right_red_ && !node_curr->right_->left_red_) {
+      move_red_right(slot, slot_red);
+    }
+    node_curr = slot;
+    if (equal_keys(key, node_key(node_curr))) {
+      // место удаляемого узла занимает его преемник: значения не
+      // переприсваиваются, узлы только перецепляются
+      node* successor = detach_min(node_curr->right_, node_curr->right_red_);
+      successor->left_ = node_curr->left_;
+      successor->left_red_ = node_curr->left_red_;
+      successor->right_ = node_curr->right_;
+      successor->right_red_ = node_curr->right_red_;
+      node_curr->left_ = node_curr->right_ = nullptr;
+      slot = successor;
+      release(node_curr);
+    } else {
+      erase_node(node_curr->right_, node_curr->right_red_, key);
+    }
+  }
+  balance(slot, slot_red);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+typename s21::persistent_tree<data_type, compare, allocator, key_of>::node*
+s21::persistent_tree<data_type, compare, allocator, key_of>::detach_min(
+    node*& slot, bool& slot_red) {
+  make_unique(slot);
+  node* node_curr = slot;
+  if (!node_curr->left_) {
+    slot = nullptr;
+    slot_red = false;
+    return node_curr;
+  }
+  if (!node_curr->left_red_ && !node_curr->left_->left_red_) {
+    move_red_left(slot, slot_red);
+  }
+  node* min = detach_min(slot->left_, slot->left_red_);
+  balance(slot, slot_red);
+  return min;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::balance(
+    node*& slot, bool& slot_red) {
+  if (slot->right_red_ && !slot->left_red_) rotate_left(slot);
+  if (slot->left_red_ && slot->left_->left_red_) rotate_right(slot);
+  if (slot->left_red_ && slot->right_red_) flip_colors(slot, slot_red);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::rotate_left(
+    node*& slot) {
+  make_unique(slot);
+  node* node_curr = slot;
+  make_unique(node_curr->right_);
+  node* right = node_curr->right_;
+  node_curr->right_ = right->left_;
+  node_curr->right_red_ = right->left_red_;
+  right->left_ = node_curr;
+  right->left_red_ = true;
+  slot = right;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator, key_of>::rotate_right(
+    node*& slot) {
+  make_unique(slot);
+  node* node_curr = slot;
+  make_unique(node_curr->left_);
+  node* left = node_curr->left_;
+  node_curr->left_ = left->right_;
+  node_curr->left_red_ = left->right_red_;
+  left->right_ = node_curr;
+  left->right_red_ = true;
+  slot = left;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator,
+                          key_of>::move_red_left(node*& slot, bool& slot_red) {
+  flip_colors(slot, slot_red);
+  if (slot->right_->left_red_) {
+    rotate_right(slot->right_);
+    rotate_left(slot);
+    flip_colors(slot, slot_red);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+void s21::persistent_tree<data_type, compare, allocator,
+                          key_of>::move_red_right(node*& slot, bool& slot_red) {
+  flip_colors(slot, slot_red);
+  if (slot->left_->left_red_) {
+    rotate_right(slot);
+    flip_colors(slot, slot_red);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of>
+bool s21::persistent_tree<data_type, compare, allocator, key_of>::is_balanced(
+    const node* node_curr, int& black_height) {
+  // чёрная высота одинакова, правых красных ссылок и двух красных подряд
+  // нет
+  if (!node_curr) {
+    black_height = 0;
+    return true;
+  }
+  int left_height = 0;
+  int right_height = 0;
+  if (!is_balanced(node_curr->left_, left_height) ||
+      !is_balanced(node_curr->right_, right_height)) {
+    return false;
+  }
+  if (node_curr->right_red_) return false;
+  if (node_curr->left_red_ && node_curr->left_->left_red_) return false;
+  left_height += node_curr->left_red_ ? 0 : 1;
+  right_height += 1;
+  black_height = left_height;
+  return left_height == right_height;
+}
+
+#endif
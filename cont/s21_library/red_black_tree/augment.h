@@ -0,0 +1,164 @@
+#ifndef S21_AUGMENT
+#define S21_AUGMENT
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace s21 {
+
+// Политики дополнения узлов rb_tree. node_data подмешивается в каждый узел,
+// update(node) пересчитывает его по детям после любого изменения структуры:
+// вставки, удаления и поворотов. maintained = false позволяет дереву вовсе
+// не проходить путь до корня.
+
+// без дополнительных данных в узлах
+struct no_augment {
+  static constexpr bool maintained = false;
+
+  template <typename data_type>
+  struct node_data {};
+
+  template <typename node_type>
+  static void update(node_type*) noexcept {}
+};
+
+// размер поддерева: nth, rank и count_range за O(log n)
+struct subtree_size {
+  static constexpr bool maintained = true;
+
+  template <typename data_type>
+  struct node_data {
+    size_t size_ = 1;
+  };
+
+  template <typename node_type>
+  static void update(node_type* node_curr) noexcept {
+    node_curr->size_ = 1 + count(node_curr->left()) + count(node_curr->right());
+  }
+
+  template <typename node_type>
+  static size_t count(const node_type* node_curr) noexcept {
+    return node_curr ? node_curr->size_ : 0;
+  }
+};
+
+// наибольший правый конец интервала в поддереве: значения — пары
+// (начало, конец), дерево упорядочено по началу. Поиск пересечений
+// пропускает поддеревья, где все интервалы кончаются до запроса
+template <typename compare>
+struct max_endpoint {
+  static constexpr bool maintained = true;
+
+  template <typename data_type>
+  struct node_data {
+    typename data_type::second_type max_end_{};
+  };
+
+  template <typename node_type>
+  static void update(node_type* node_curr) {
+    compare less;
+    const auto* high = &node_curr->data_.second;
+    if (node_curr->left() && less(*high, node_curr->left()->max_end_)) {
+      high = &node_curr->left()->max_end_;
+    }
+    if (node_curr->right() && less(*high, node_curr->right()->max_end_)) {
+      high = &node_curr->right()->max_end_;
+    }
+    node_curr->max_end_ = *high;
+  }
+};
+
+// агрегат значений поддерева по моноиду: monoid задаёт value_type,
+// нейтральный identity() и ассоциативную combine(a, b). У map в агрегат
+// попадает значение пары, у set — сам ключ. rb_tree::aggregate(lo, hi)
+// сворачивает полуинтервал ключей за O(log n). Итераторы, at и
+// operator[] такого дерева дают только константный доступ, а значения map
+// меняются через insert_or_assign и update, пересчитывающие агрегат
+template <typename monoid>
+struct monoid_augment {
+  static constexpr bool maintained = true;
+  using value_type = typename monoid::value_type;
+
+  template <typename data_type>
+  struct node_data {
+    value_type aggregate_ = monoid::identity();
+  };
+
+  template <typename node_type>
+  static void update(node_type* node_curr) {
+    node_curr->aggregate_ = monoid::combine(
+        monoid::combine(of(node_curr->left()), lift(node_curr->data_)),
+        of(node_curr->right()));
+  }
+
+  template <typename node_type>
+  static value_type of(const node_type* node_curr) {
+    return node_curr ? node_curr->aggregate_ : monoid::identity();
+  }
+  template <typename key_type, typename mapped_type>
+  static const mapped_type& lift(const std::pair<key_type, mapped_type>& data) {
+    return data.second;
+  }
+  template <typename data_type>
+  static const data_type& lift(const data_type& data) {
+    return data;
+  }
+  static value_type identity() { return monoid::identity(); }
+  static value_type combine(const value_type& a, const value_type& b) {
+    return monoid::combine(a, b);
+  }
+};
+
+template <typename T>
+struct sum_monoid {
+  using value_type = T;
+  static T identity() { return T(); }
+  static T combine(const T& a, const T& b) { return a + b; }
+};
+
+template <typename T>
+struct min_monoid {
+  using value_type = T;
+  static T identity() { return std::numeric_limits<T>::max(); }
+  static T combine(const T& a, const T& b) { return std::min(a, b); }
+};
+
+template <typename T>
+struct max_monoid {
+  using value_type = T;
+  static T identity() { return std::numeric_limits<T>::lowest(); }
+  static T combine(const T& a, const T& b) { return std::max(a, b); }
+};
+
+template <typename T>
+using range_sum = monoid_augment<sum_monoid<T>>;
+template <typename T>
+using range_min = monoid_augment<min_monoid<T>>;
+template <typename T>
+using range_max = monoid_augment<max_monoid<T>>;
+
+// политика умеет считать узлы в поддереве
+template <typename augment, typename = void>
+struct counts_nodes : std::false_type {};
+
+template <typename augment>
+struct counts_nodes<augment,
+                    std::void_t<decltype(augment::count(
+                        static_cast<const typename augment::template node_data<
+                            int>*>(nullptr)))>> : std::true_type {};
+
+// политика хранит агрегат моноида
+template <typename augment, typename = void>
+struct aggregates_values : std::false_type {};
+
+template <typename augment>
+struct aggregates_values<augment,
+                         std::void_t<decltype(augment::identity())>>
+    : std::true_type {};
+
+}  // namespace s21
+
+#endif
@@ -0,0 +1,349 @@
+#ifndef S21_NODE_POOL
+#define S21_NODE_POOL
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Если для аллокатора узлов это true_type, пул не заводит слэбов: каждый
+// узел берётся у аллокатора и возвращается ему отдельно, как в rb_tree до
+// node_pool. Так бенчмарки сравнивают одно и то же дерево с пулом и без.
+template <typename allocator>
+struct per_node_allocation : std::false_type {};
+
+// Раздаёт память под узлы дерева из непрерывных слэбов. Освобождённые узлы
+// попадают в free list и переиспользуются, а сами слэбы возвращаются
+// аллокатору только целиком — в release() и в деструкторе.
+//
+// Деревья, которые передают друг другу узлы (merge, extract/insert),
+// объединяют пулы через unite(): слэбы переезжают в один пул, а опустевший
+// пул ссылается на него. Владельцы держат пул через shared_ptr, поэтому
+// слэбы живут, пока жив хотя бы один узел из них.
+//
+// Узлы раздаются и возвращаются через статические функции, которым
+// передаётся указатель владельца: они доходят до итогового пула цепочки.
+// Пул, достижимый из нескольких владельцев (после unite или share), может
+// использоваться ими из разных потоков, поэтому работает под мьютексом;
+// пул единственного владельца мьютекс не трогает.
+template <typename node_type, typename allocator = std::allocator<node_type>>
+class node_pool {
+  union slot {
+    slot* next_;
+    alignas(node_type) unsigned char storage_[sizeof(node_type)];
+  };
+  using slot_allocator =
+      typename std::allocator_traits<allocator>::template rebind_alloc<slot>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+
+ public:
+  static constexpr size_t min_slab_nodes = 16;
+  static constexpr size_t max_slab_nodes = 4096;
+
+  node_pool() : node_pool(allocator()) {}
+  explicit node_pool(const allocator& alloc)
+      : alloc_(alloc),
+        free_(nullptr),
+        current_(nullptr),
+        end_(nullptr),
+        next_slab_nodes_(min_slab_nodes),
+      shared_(false) {}
+  node_pool(const node_pool& other) = delete;
+  node_pool(node_pool&& other) noexcept;
+  ~node_pool() { release(); }
+
+  node_pool& operator=(const node_pool& other) = delete;
+  node_pool& operator=(node_pool&& other) noexcept;
+
+  static node_type* allocate(std::shared_ptr<node_pool>& pool);
+  // заводит слэб ровно под count узлов, если в текущем столько не осталось:
+  // пока free list пуст, следующие count узлов идут подряд
+  static void reserve(std::shared_ptr<node_pool>& pool, size_t count);
+  static void deallocate(std::shared_ptr<node_pool>& pool,
+                         node_type* ptr) noexcept;
+  // возвращает слэбы аллокатору, если у пула не осталось других владельцев
+  static bool release_if_exclusive(std::shared_ptr<node_pool>& pool) noexcept;
+  void release() noexcept;
+  void swap(node_pool& other) noexcept;
+
+  static node_pool& resolve(std::shared_ptr<node_pool>& pool);
+  // pool получает второго владельца: например, узел, вынесенный в
+  // node_handle, или вторую половину split
+  static void share(std::shared_ptr<node_pool>& pool);
+  // оба владельца остаются у итогового пула
+  static void unite(std::shared_ptr<node_pool>& lhs,
+                    std::shared_ptr<node_pool>& rhs);
+  // то же, но владелец rhs отпускает пул: rhs сбрасывается, и lhs
+  // становится общим, только если общим был пул rhs
+  static void splice(std::shared_ptr<node_pool>& lhs,
+                     std::shared_ptr<node_pool>&& rhs);
+
+  allocator get_allocator() const { return allocator(alloc_); }
+  size_t slab_count() const noexcept { return slabs_.size(); }
+  size_t capacity() const noexcept;
+
+ private:
+  slot_allocator alloc_;
+  std::vector<std::pair<slot*, size_t>> slabs_;
+  slot* free_;
+  slot* current_;
+  slot* end_;
+  size_t next_slab_nodes_;
+  std::shared_ptr<node_pool> merged_into_;
+  std::mutex mutex_;
+  std::atomic<bool> shared_;
+
+  // op над итоговым пулом цепочки; общий пул заперт, пока op работает,
+  // чтобы его не влили в другой между поиском и op
+  static void merge_pools(std::shared_ptr<node_pool>& lhs,
+                          std::shared_ptr<node_pool>& rhs, bool rhs_stays);
+  template <typename operation>
+  static decltype(auto) locked(std::shared_ptr<node_pool>& pool,
+                               operation&& op);
+  node_type* pop_slot();
+  void reserve_slab(size_t count);
+  void push_slot(node_type* ptr) noexcept;
+  void grow();
+  void absorb(node_pool& other);
+};
+}  // namespace s21
+
+template <typename node_type, typename allocator>
+s21::node_pool<node_type, allocator>::node_pool(node_pool&& other) noexcept
+    : alloc_(std::move(other.alloc_)),
+      slabs_(std::move(other.slabs_)),
+      free_(other.free_),
+      current_(other.current_),
+      end_(other.end_),
+      next_slab_nodes_(other.next_slab_nodes_),
+      merged_into_(std::move(other.merged_into_)),
+      shared_(other.shared_.load()) {
+  other.slabs_.clear();
+  other.free_ = other.current_ = other.end_ = nullptr;
+  other.next_slab_nodes_ = min_slab_nodes;
+}
+
+template <typename node_type, typename allocator>
+s21::node_pool<node_type, allocator>&
+s21::node_pool<node_type, allocator>::operator=(node_pool&& other) noexcept {
+  if (this != &other) {
+    release();
+    swap(other);
+  }
+  return *this;
+}
+
+template <typename node_type, typename allocator>
+template <typename operation>
+decltype(auto) s21::node_pool<node_type, allocator>::locked(
+    std::shared_ptr<node_pool>& pool, operation&& op) {
+  for (;;) {
+    node_pool& current = *pool;
+    std::unique_lock<std::mutex> lock(current.mutex_, std::defer_lock);
+    if (current.shared_.load(std::memory_order_acquire)) lock.lock();
+    if (!current.merged_into_) return op(current);
+    // ссылка владельца сразу переставляется на следующий пул
+    std::shared_ptr<node_pool> target = current.merged_into_;
+    if (lock.owns_lock()) lock.unlock();
+    pool = std::move(target);
+  }
+}
+
+template <typename node_type, typename allocator>
+node_type* s21::node_pool<node_type, allocator>::allocate(
+    std::shared_ptr<node_pool>& pool) {
+  return locked(pool, [](node_pool& nodes) { return nodes.pop_slot(); });
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::reserve(
+    std::shared_ptr<node_pool>& pool, size_t count) {
+  locked(pool, [count](node_pool& nodes) { nodes.reserve_slab(count); });
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::deallocate(
+    std::shared_ptr<node_pool>& pool, node_type* ptr) noexcept {
+  if (!ptr) return;
+  locked(pool, [ptr](node_pool& nodes) { nodes.push_slot(ptr); });
+}
+
+template <typename node_type, typename allocator>
+bool s21::node_pool<node_type, allocator>::release_if_exclusive(
+    std::shared_ptr<node_pool>& pool) noexcept {
+  // узлы без слэбов возвращаются аллокатору только по одному
+  if constexpr (per_node_allocation<allocator>::value) return false;
+  return locked(pool, [&pool](node_pool& nodes) {
+    // бывшие владельцы, уже отпустившие пул, работали с ним под тем же
+    // мьютексом, так что их операции видны
+    if (pool.use_count() > 1) return false;
+    nodes.release();
+    return true;
+  });
+}
+
+template <typename node_type, typename allocator>
+node_type* s21::node_pool<node_type, allocator>::pop_slot() {
+  if constexpr (per_node_allocation<allocator>::value) {
+    slot* single = slot_traits::allocate(alloc_, 1);
+    return reinterpret_cast<node_type*>(single->storage_);
+  }
+  slot* result = free_;
+  if (result) {
+    free_ = result->next_;
+  } else {
+    if (current_ == end_) grow();
+    result = current_++;
+  }
+  return reinterpret_cast<node_type*>(result->storage_);
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::reserve_slab(size_t count) {
+  if constexpr (per_node_allocation<allocator>::value) return;
+  if (static_cast<size_t>(end_ - current_) >= count) return;
+  slabs_.reserve(slabs_.size() + 1);
+  slot* slab = slot_traits::allocate(alloc_, count);
+  slabs_.emplace_back(slab, count);
+  // неразданный остаток прежнего слэба уходит в free list
+  for (slot* it = current_; it != end_; ++it) {
+    it->next_ = free_;
+    free_ = it;
+  }
+  current_ = slab;
+  end_ = slab + count;
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::push_slot(node_type* ptr) noexcept {
+  slot* freed = reinterpret_cast<slot*>(ptr);
+  if constexpr (per_node_allocation<allocator>::value) {
+    slot_traits::deallocate(alloc_, freed, 1);
+    return;
+  }
+  freed->next_ = free_;
+  free_ = freed;
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::release() noexcept {
+  for (auto& slab : slabs_) {
+    slot_traits::deallocate(alloc_, slab.first, slab.second);
+  }
+  slabs_.clear();
+  free_ = current_ = end_ = nullptr;
+  next_slab_nodes_ = min_slab_nodes;
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::swap(node_pool& other) noexcept {
+  using std::swap;
+  swap(alloc_, other.alloc_);
+  swap(slabs_, other.slabs_);
+  swap(free_, other.free_);
+  swap(current_, other.current_);
+  swap(end_, other.end_);
+  swap(next_slab_nodes_, other.next_slab_nodes_);
+  swap(merged_into_, other.merged_into_);
+  shared_.store(other.shared_.exchange(shared_.load()));
+}
+
+template <typename node_type, typename allocator>
+s21::node_pool<node_type, allocator>&
+s21::node_pool<node_type, allocator>::resolve(
+    std::shared_ptr<node_pool>& pool) {
+  return locked(pool, [](node_pool& nodes) -> node_pool& { return nodes; });
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::share(
+    std::shared_ptr<node_pool>& pool) {
+  locked(pool, [](node_pool& nodes) {
+    nodes.shared_.store(true, std::memory_order_release);
+  });
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::unite(
+    std::shared_ptr<node_pool>& lhs, std::shared_ptr<node_pool>& rhs) {
+  merge_pools(lhs, rhs, true);
+  rhs = lhs;
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::splice(
+    std::shared_ptr<node_pool>& lhs, std::shared_ptr<node_pool>&& rhs) {
+  if (!rhs) return;
+  merge_pools(lhs, rhs, false);
+  rhs.reset();
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::merge_pools(
+    std::shared_ptr<node_pool>& lhs, std::shared_ptr<node_pool>& rhs,
+    bool rhs_stays) {
+  for (;;) {
+    node_pool& target = resolve(lhs);
+    node_pool& source = resolve(rhs);
+    if (&target == &source) return;
+    std::scoped_lock lock(target.mutex_, source.mutex_);
+    // другой владелец мог успеть влить один из пулов дальше
+    if (target.merged_into_ || source.merged_into_) continue;
+    target.slabs_.reserve(target.slabs_.size() + source.slabs_.size());
+    target.absorb(source);
+    source.merged_into_ = lhs;
+    // необщий source достижим только через rhs: если тот отпускает пул,
+    // у target не появляется второго владельца
+    if (rhs_stays || source.shared_.load(std::memory_order_relaxed)) {
+      target.shared_.store(true, std::memory_order_release);
+      source.shared_.store(true, std::memory_order_release);
+    }
+    return;
+  }
+}
+
+template <typename node_type, typename allocator>
+size_t s21::node_pool<node_type, allocator>::capacity() const noexcept {
+  size_t result = 0;
+  for (const auto& slab : slabs_) result += slab.second;
+  return result;
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::grow() {
+  size_t count = next_slab_nodes_;
+  slabs_.reserve(slabs_.size() + 1);
+  slot* slab = slot_traits::allocate(alloc_, count);
+  slabs_.emplace_back(slab, count);
+  current_ = slab;
+  end_ = slab + count;
+  if (next_slab_nodes_ < max_slab_nodes) next_slab_nodes_ *= 2;
+}
+
+template <typename node_type, typename allocator>
+void s21::node_pool<node_type, allocator>::absorb(node_pool& other) {
+  slabs_.insert(slabs_.end(), other.slabs_.begin(), other.slabs_.end());
+  // неразданный остаток текущего слэба other уходит в общий free list
+  for (slot* it = other.current_; it != other.end_; ++it) {
+    it->next_ = free_;
+    free_ = it;
+  }
+  if (other.free_) {
+    slot* tail = other.free_;
+    while (tail->next_) tail = tail->next_;
+    tail->next_ = free_;
+    free_ = other.free_;
+  }
+  if (other.next_slab_nodes_ > next_slab_nodes_) {
+    next_slab_nodes_ = other.next_slab_nodes_;
+  }
+  other.slabs_.clear();
+  other.free_ = other.current_ = other.end_ = nullptr;
+}
+
+#endif
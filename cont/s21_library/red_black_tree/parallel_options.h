@@ -0,0 +1,22 @@
+#ifndef S21_PARALLEL_OPTIONS
+#define S21_PARALLEL_OPTIONS
+
+#include <cstddef>
+#include <thread>
+
+namespace s21 {
+
+// Настройки параллельных операций над деревьями. threads ограничивает число
+// одновременно работающих потоков, а части меньше sequential_cutoff узлов
+// обрабатываются в текущем потоке: на них запуск задачи дороже самой работы.
+struct parallel_options {
+  size_t threads = std::thread::hardware_concurrency();
+  size_t sequential_cutoff = size_t(1) << 14;
+  // параллельное копирование делит дерево только на верхних fork_depth
+  // уровнях: ниже поддеревья копируются в уже запущенных потоках
+  size_t fork_depth = 4;
+};
+
+}  // namespace s21
+
+#endif
@@ -1,38 +1,206 @@
 #ifndef S21_RB_TREE
 #define S21_RB_TREE
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <stack>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "augment.h"
+#include "node_pool.h"
+#include "parallel_options.h"
 
 namespace s21 {
 
-template <typename data_type, typename compare = std::less<data_type>>
+// достают из хранимого значения ключ, по которому упорядочено дерево
+struct identity_key {
+  template <typename value_type>
+  const value_type& operator()(const value_type& value) const {
+    return value;
+  }
+};
+
+struct select_first {
+  template <typename pair_type>
+  const typename pair_type::first_type& operator()(
+      const pair_type& value) const {
+    return value.first;
+  }
+};
+
+template <typename data_type, typename compare = std::less<data_type>,
+          typename allocator = std::allocator<data_type>,
+          typename key_of = identity_key, typename augment = no_augment>
 class rb_tree {
  protected:
   enum color_node { red, black };
+  static constexpr std::uintptr_t color_mask = 1;
   struct node;
 
  public:
+  using key_type =
+      std::decay_t<std::invoke_result_t<key_of, const data_type&>>;
+  // агрегат monoid_augment зависит от значений, поэтому такое дерево
+  // отдаёт элементы только для чтения: запись по ссылке обошла бы пересчёт
+  static constexpr bool read_only_values = aggregates_values<augment>::value;
+  using value_reference =
+      std::conditional_t<read_only_values, const data_type&, data_type&>;
   class iterator;
   class const_iterator;
+  class node_handle;
+  struct insert_return_type;
 
   rb_tree() : root_(nullptr), size_(0){};
+  explicit rb_tree(const allocator& alloc)
+      : root_(nullptr), size_(0), alloc_(alloc) {}
   rb_tree(const rb_tree& other);
+  // копия, у которой верхние options.fork_depth уровней делятся между
+  // потоками: левое поддерево уходит в новый поток, правое копирует
+  // текущий. Каждое поддерево ниже копируется в заранее выделенный
+  // непрерывный слэб своего потока, потом пулы объединяются
+  rb_tree(const rb_tree& other, const parallel_options& options);
   rb_tree(rb_tree&& other) noexcept;
   rb_tree(std::initializer_list<data_type> const& elem);
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  rb_tree(input_iterator first, input_iterator last);
   ~rb_tree() { clear(); }
 
   rb_tree& operator=(rb_tree&& other) noexcept;
 
-  iterator begin() { return iterator(root_ ? min_node(root_) : nullptr, this); }
-  iterator end() { return iterator(nullptr, this); }
-  iterator find(const data_type& value);
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-  const_iterator cbegin() const {
-    return const_iterator(root_ ? min_node(root_) : nullptr, this);
+  iterator begin() { return iterator(header_.left(), this); }
+  iterator end() { return iterator(&header_, this); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  iterator find(const key_type& key) {
+    return iterator(find_or_end(key), this);
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  iterator find(const other_key& key) {
+    return iterator(find_or_end(key), this);
+  }
+
+  const_iterator cbegin() const { return const_iterator(header_.left(), this); }
+  const_iterator cend() const { return const_iterator(&header_, this); }
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(cend());
+  }
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(cbegin());
+  }
+  const_iterator find(const key_type& key) const {
+    return const_iterator(find_or_end(key), this);
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  const_iterator find(const other_key& key) const {
+    return const_iterator(find_or_end(key), this);
+  }
+  // пакетный поиск: в out по порядку пишется find(key) для каждого ключа
+  // из [first, last). Спуски нескольких ключей чередуются, и следующий
+  // узел каждого спуска запрашивается из памяти заранее, пока остальные
+  // сравнивают уже загруженные узлы
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator find_batch(forward_iterator first, forward_iterator last,
+                             output_iterator out) {
+    find_nodes_batch(first, last, [&](node* found) {
+      *out++ = iterator(found ? found : &header_, this);
+    });
+    return out;
+  }
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator find_batch(forward_iterator first, forward_iterator last,
+                             output_iterator out) const {
+    find_nodes_batch(first, last, [&](const node* found) {
+      *out++ = const_iterator(found ? found : &header_, this);
+    });
+    return out;
+  }
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator contains_batch(forward_iterator first, forward_iterator last,
+                                 output_iterator out) const {
+    find_nodes_batch(first, last,
+                     [&](const node* found) { *out++ = found != nullptr; });
+    return out;
+  }
+
+  iterator lower_bound(const key_type& key) {
+    return iterator(lower_node(key), this);
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  iterator lower_bound(const other_key& key) {
+    return iterator(lower_node(key), this);
+  }
+  const_iterator lower_bound(const key_type& key) const {
+    return const_iterator(lower_node(key), this);
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  const_iterator lower_bound(const other_key& key) const {
+    return const_iterator(lower_node(key), this);
+  }
+  iterator upper_bound(const key_type& key) {
+    return iterator(upper_node(key), this);
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  iterator upper_bound(const other_key& key) {
+    return iterator(upper_node(key), this);
+  }
+  const_iterator upper_bound(const key_type& key) const {
+    return const_iterator(upper_node(key), this);
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  const_iterator upper_bound(const other_key& key) const {
+    return const_iterator(upper_node(key), this);
+  }
+  std::pair<iterator, iterator> equal_range(const key_type& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  std::pair<iterator, iterator> equal_range(const other_key& key) {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  std::pair<const_iterator, const_iterator> equal_range(
+      const other_key& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  // fn(value) для каждого значения с ключом из [lo, hi) по порядку; обход
+  // спускается только в поддеревья, пересекающие интервал, и обходится
+  // без итераторов и подъёмов к родителям
+  template <typename function>
+  void for_each_in_range(const key_type& lo, const key_type& hi,
+                         function&& fn) {
+    visit_range(root_, lo, hi, fn);
+  }
+  template <typename function>
+  void for_each_in_range(const key_type& lo, const key_type& hi,
+                         function&& fn) const {
+    auto visit = [&fn](const data_type& data) { fn(data); };
+    visit_range(root_, lo, hi, visit);
   }
-  const_iterator cend() const { return const_iterator(nullptr, this); }
-  const_iterator find(const data_type& value) const;
 
   size_t size() const noexcept { return size_; }
   size_t max_size() const noexcept {
@@ -40,13 +208,48 @@ class rb_tree {
         std::allocator<node>());
   }
   bool empty() const noexcept { return size_ == 0; }
+  allocator get_allocator() const { return alloc_; }
 
   void clear();
-  virtual std::pair<iterator, bool> insert_data(const data_type& data);
+  template <typename input_iterator>
+  void assign_sorted(input_iterator first, input_iterator last) {
+    assign_range(first, last, true);
+  }
+  std::pair<iterator, bool> insert_data(const data_type& data);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return emplace_value(unique_keys(), std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return emplace_hint_value(unique_keys(), hint, std::forward<Args>(args)...)
+        .first;
+  }
   void erase(iterator pos);
+  // [first, last) удаляется за один проход: дерево разрезается перед
+  // last и перед first, середина уничтожается, края склеиваются. Это
+  // O(log n + k) без перебалансировки после каждого узла
+  iterator erase(const_iterator first, const_iterator last);
+  node_handle extract(const_iterator pos);
+  node_handle extract(const key_type& key) { return extract(find(key)); }
   void swap(rb_tree& other) noexcept;
   void merge(rb_tree& other);
 
+  // порядковые статистики, только с политикой subtree_size
+  iterator nth(size_t index) { return iterator(nth_node(index), this); }
+  const_iterator nth(size_t index) const {
+    return const_iterator(nth_node(index), this);
+  }
+  size_t rank(const key_type& key) const;
+  // число элементов в полуинтервале [lo, hi)
+  size_t count_range(const key_type& lo, const key_type& hi) const {
+    return compare_(lo, hi) ? rank(hi) - rank(lo) : 0;
+  }
+  // свёртка значений с ключами из [lo, hi), только с monoid_augment
+  template <typename policy = augment>
+  typename policy::value_type aggregate(const key_type& lo,
+                                        const key_type& hi) const;
+
   // вспомогательные функции
   void print() const;
   bool is_balanced() const {
@@ -57,71 +260,302 @@ class rb_tree {
   bool is_balanced_red_black(node* node_curr) const;
 
  protected:
-  struct node {
-    data_type data_;
-    node* left_;
-    node* right_;
-    node* parent_;
-    color_node color_;
-    node(const data_type& data, node* parent)
-        : data_(data),
-          left_(nullptr),
-          right_(nullptr),
-          parent_(parent),
-          color_(red) {}
+  using node_data = typename augment::template node_data<data_type>;
+  struct node : node_data {
+    // у заголовка значение не создаётся, поэтому оно лежит в union
+    union {
+      data_type data_;
+    };
+    // потомки лежат массивом: спуск выбирает child_[key > node_key] по
+    // результату сравнения, без условного перехода
+    node* child_[2];
+    // цвет хранится в младшем бите указателя на родителя: узел содержит
+    // указатели и выровнен как они, так что этот бит всегда свободен
+    std::uintptr_t parent_color_;
+    node() : child_{this, this}, parent_color_(red) {}
+    template <typename... Args>
+    explicit node(node* parent, Args&&... args)
+        : data_(std::forward<Args>(args)...),
+          child_{nullptr, nullptr},
+          parent_color_(reinterpret_cast<std::uintptr_t>(parent) | red) {}
+    ~node() {}
+
+    node*& left() noexcept { return child_[0]; }
+    node* left() const noexcept { return child_[0]; }
+    node*& right() noexcept { return child_[1]; }
+    node* right() const noexcept { return child_[1]; }
+
+    node* parent() const noexcept {
+      return reinterpret_cast<node*>(parent_color_ & ~color_mask);
+    }
+    void set_parent(node* parent) noexcept {
+      parent_color_ = reinterpret_cast<std::uintptr_t>(parent) |
+                      (parent_color_ & color_mask);
+    }
+    color_node color() const noexcept {
+      return static_cast<color_node>(parent_color_ & color_mask);
+    }
+    void set_color(color_node color) noexcept {
+      parent_color_ = (parent_color_ & ~color_mask) | color;
+    }
   };
 
   node* root_;
+  // заголовок служит позицией end(): left() и right() указывают на минимум
+  // и максимум, у пустого дерева — на сам заголовок. Родитель корня
+  // остаётся nullptr, так что повороты заголовок не затрагивают
+  node header_;
   size_t size_;
   compare compare_;
+  allocator alloc_;
+  // пул создаётся при первой вставке; после merge и вставки узлов из
+  // node_handle он общий с другими деревьями
+  using pool_type = node_pool<node, allocator>;
+  std::shared_ptr<pool_type> pool_;
+
+  std::shared_ptr<pool_type>& pool() {
+    if (!pool_) pool_ = std::allocate_shared<pool_type>(alloc_, alloc_);
+    return pool_;
+  }
+  // узлы other_pool переходят в это дерево, а его владелец продолжает
+  // пользоваться пулом; пул становится общим и работает под мьютексом
+  void adopt_pool(std::shared_ptr<pool_type>& other_pool);
+  // владелец other_pool отпускает пул: так сливаются деревья, которые
+  // после операции пусты
+  void adopt_pool(std::shared_ptr<pool_type>&& other_pool);
+
+  // split/join: *this разбирается или собирается из готовых поддеревьев
+  void split_into(const key_type& key, rb_tree& left, rb_tree& right);
+  void join_trees(rb_tree& left, rb_tree& right);
+  void join_trees(rb_tree& left, node* pivot, rb_tree& right);
+  template <typename... Args>
+  void join_trees_with(rb_tree& left, rb_tree& right, Args&&... pivot_args);
+  void split_node(node* node_curr, size_t height, const key_type& key,
+                  node*& left, size_t& left_height, node*& right,
+                  size_t& right_height);
+  // разрез перед узлом boundary; path — путь к нему, path[0] == node_curr
+  void split_before(node* node_curr, size_t height, node* const* path,
+                    node* boundary, node*& left, size_t& left_height,
+                    node*& right, size_t& right_height);
+  // путь от корня до node_curr включительно; высота красно-чёрного дерева
+  // не больше удвоенного числа бит в size_t
+  static constexpr size_t max_depth = 2 * std::numeric_limits<size_t>::digits;
+  static void path_to(node* node_curr, node** path) noexcept;
+  node* join_roots(node* left, size_t left_height, node* pivot, node* right,
+                   size_t right_height, size_t& height);
+  bool pivot_fits(const rb_tree& left, const node* pivot,
+                  const rb_tree& right) const;
+  static size_t root_black_height(const node* node_curr) noexcept;
+  void attach_root(node* new_root, size_t count);
+  void detach_nodes() noexcept {
+    root_ = nullptr;
+    reset_header();
+    size_ = 0;
+  }
+
+  // объединение, пересечение и разность: узлы обоих деревьев переходят в
+  // *this, лишние уничтожаются
+  enum class set_operation { union_of, intersection_of, difference_of };
+  struct combine_context {
+    set_operation operation_;
+    bool unique_;
+    size_t cutoff_;
+  };
+  void combine_trees(rb_tree& left, rb_tree& right, set_operation operation,
+                     const parallel_options& options);
+  node* combine_nodes(node* left, size_t left_height, node* right,
+                      size_t right_height, size_t& height,
+                      const combine_context& context, size_t threads,
+                      std::vector<node*>& discarded);
+  void split_equal(node* node_curr, size_t height, const key_type& key,
+                   bool unique, node*& left, size_t& left_height,
+                   std::vector<node*>& equal, node*& right,
+                   size_t& right_height);
+  node* join_two(node* left, size_t left_height, node* right,
+                 size_t right_height, size_t& height);
+  node* split_last(node* node_curr, size_t height, node*& last,
+                   size_t& rest_height);
+  static void collect_nodes(node* node_curr, std::vector<node*>& nodes);
+  static size_t estimate_size(const node* node_curr, size_t height) noexcept;
+
+  static const key_type& node_key(const node* node_curr) {
+    return key_of()(node_curr->data_);
+  }
+  // арифметические ключи в порядке std::less или std::greater сравниваются
+  // одной трёхсторонней операцией, и спуск берёт child_[order > 0] без
+  // второго сравнения и условного перехода
+  static constexpr bool reversed_order =
+      std::is_same_v<compare, std::greater<key_type>> ||
+      std::is_same_v<compare, std::greater<>>;
+  template <typename other_key>
+  static constexpr bool native_order =
+      std::is_arithmetic_v<key_type> && std::is_same_v<other_key, key_type> &&
+      (reversed_order || std::is_same_v<compare, std::less<key_type>> ||
+       std::is_same_v<compare, std::less<>>);
+  // больше нуля, если key идёт после ключа узла, ноль при равенстве
+  static int three_way(key_type key, key_type node_key) noexcept {
+    if constexpr (reversed_order) return (key < node_key) - (node_key < key);
+    return (node_key < key) - (key < node_key);
+  }
+  template <typename other_key>
+  node* find_node(const other_key& key) const;
+  // сколько спусков find_nodes_batch ведёт одновременно
+  static constexpr size_t batch_lanes = 16;
+  template <typename forward_iterator, typename function>
+  void find_nodes_batch(forward_iterator first, forward_iterator last,
+                        function&& emit) const;
+  static void prefetch_node(const node* node_curr) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(node_curr);
+#else
+    (void)node_curr;
+#endif
+  }
+  template <typename other_key>
+  node* lower_node(const other_key& key) const;
+  template <typename other_key>
+  node* upper_node(const other_key& key) const;
+  template <typename function>
+  void visit_range(node* node_curr, const key_type& lo, const key_type& hi,
+                   function& fn) const;
+  template <typename other_key>
+  node* find_or_end(const other_key& key) const {
+    node* found = find_node(key);
+    return found ? found : const_cast<node*>(&header_);
+  }
+  void reset_header() noexcept { header_.left() = header_.right() = &header_; }
+
+  // куда вставлять ключ: родитель и сторона, либо уже существующий узел
+  struct insert_position {
+    node* parent_;
+    bool left_;
+    node* existing_;
+  };
 
+  // multiset переопределяет, чтобы общие вставки допускали дубликаты
+  virtual bool unique_keys() const noexcept { return true; }
+  template <typename... Args>
+  node* create_node(node* parent, Args&&... args);
+  void destroy_node(node* node_curr) noexcept;
   node* copy_tree(node* src);
+  node* copy_parallel(node* src, size_t height, size_t depth, size_t threads,
+                      const parallel_options& options);
+  static size_t subtree_nodes(const node* node_curr);
+  static void copy_node_state(node* copy, const node* src) {
+    copy->set_color(src->color());
+    static_cast<node_data&>(*copy) = static_cast<const node_data&>(*src);
+  }
+  void destroy_subtree(node* node_curr) noexcept;
+  template <typename other_key>
+  insert_position find_insert_position(const other_key& key,
+                                       bool unique) const;
+  template <typename other_key>
+  insert_position find_hint_position(const_iterator hint,
+                                     const other_key& key, bool unique) const;
+  void link_node(node* new_node, const insert_position& position);
+  void unlink_node(node* node_to_delete);
+  std::pair<iterator, bool> insert_handle(bool unique, const_iterator hint,
+                                          node_handle& handle);
+  template <typename value_arg>
+  std::pair<iterator, bool> insert_value(bool unique, value_arg&& value) {
+    return insert_hint_value(unique, const_iterator(),
+                             std::forward<value_arg>(value));
+  }
+  template <typename value_arg>
+  std::pair<iterator, bool> insert_hint_value(bool unique, const_iterator hint,
+                                              value_arg&& value);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_value(bool unique, Args&&... args) {
+    return emplace_hint_value(unique, const_iterator(),
+                              std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_hint_value(bool unique,
+                                               const_iterator hint,
+                                               Args&&... args);
+  template <typename input_iterator>
+  void assign_range(input_iterator first, input_iterator last, bool unique);
+  template <typename forward_iterator>
+  node* build_sorted(forward_iterator& first, forward_iterator last,
+                     size_t count, size_t depth, size_t red_depth,
+                     bool unique);
   node* max_node(node* node_curr) const;
   node* min_node(node* node_curr) const;
+  node* nth_node(size_t index) const;
+  // пересчёт дополнения от узла до корня после изменения структуры
+  void update_path(node* node_curr) noexcept {
+    if constexpr (augment::maintained) {
+      for (; node_curr; node_curr = node_curr->parent()) {
+        augment::update(node_curr);
+      }
+    }
+  }
   void rotate_left(node* node_curr);
   void rotate_right(node* node_curr);
-  void fix_violation(node* node_curr);
-  void delete_fix(node* node_curr);
+  bool fix_violation(node* node_curr);
+  void transplant(node* old_node, node* new_node);
+  void delete_fix(node* node_curr, node* parent);
+  static bool is_black(const node* node_curr) {
+    return !node_curr || node_curr->color() == black;
+  }
 };
 
-template <typename data_type, typename compare>
-class rb_tree<data_type, compare>::iterator {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+class rb_tree<data_type, compare, allocator, key_of, augment>::iterator {
  public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_reference;
+  using pointer = std::remove_reference_t<reference>*;
+
   iterator() : ptr_(nullptr), tree_(nullptr) {}
   iterator(node* ptr, rb_tree* tree) : ptr_(ptr), tree_(tree) {}
   iterator(const iterator& other) : ptr_(other.ptr_), tree_(other.tree_) {}
 
-  data_type& operator*();
+  reference operator*();
   const data_type& operator*() const;
 
-  data_type* operator->() { return &(ptr_->data_); }
+  pointer operator->() { return &(ptr_->data_); }
   iterator& operator=(const iterator& other);
   iterator& operator++();
   iterator operator++(int);
   iterator& operator--();
   iterator operator--(int);
-  bool operator==(const iterator& other) {
+  bool operator==(const iterator& other) const {
     return ptr_ == other.ptr_ && tree_ == other.tree_;
   }
-  bool operator!=(const iterator& other) {
+  bool operator!=(const iterator& other) const {
     return ptr_ != other.ptr_ || tree_ != other.tree_;
   }
 
   node* get_node() const { return ptr_; }
 
  protected:
+  friend class rb_tree;
+  friend class const_iterator;
   node* ptr_;
   rb_tree* tree_;
 };
 
-template <typename data_type, typename compare>
-class rb_tree<data_type, compare>::const_iterator {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+class rb_tree<data_type, compare, allocator, key_of, augment>::const_iterator {
  public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const data_type*;
+  using reference = const data_type&;
+
   const_iterator() : ptr_(nullptr), tree_(nullptr) {}
   const_iterator(const node* ptr, const rb_tree* tree)
       : ptr_(ptr), tree_(tree) {}
   const_iterator(const const_iterator& other)
       : ptr_(other.ptr_), tree_(other.tree_) {}
+  const_iterator(const iterator& other)
+      : ptr_(other.ptr_), tree_(other.tree_) {}
 
   const data_type& operator*() const;
   const data_type* operator->() const { return &(ptr_->data_); }
@@ -138,13 +572,81 @@ class rb_tree<data_type, compare>::const_iterator {
   }
 
  protected:
+  friend class rb_tree;
   const node* ptr_;
   const rb_tree* tree_;
 };
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+class rb_tree<data_type, compare, allocator, key_of, augment>::node_handle {
+ public:
+  using value_type = data_type;
+  using allocator_type = allocator;
+
+  node_handle() : node_(nullptr) {}
+  node_handle(node_handle&& other) noexcept
+      : node_(other.node_), pool_(std::move(other.pool_)) {
+    other.node_ = nullptr;
+  }
+  ~node_handle() { reset(); }
+
+  node_handle& operator=(node_handle&& other) noexcept {
+    if (this != &other) {
+      reset();
+      node_ = other.node_;
+      pool_ = std::move(other.pool_);
+      other.node_ = nullptr;
+    }
+    return *this;
+  }
+
+  bool empty() const noexcept { return node_ == nullptr; }
+  explicit operator bool() const noexcept { return node_ != nullptr; }
+  allocator get_allocator() const { return pool_->get_allocator(); }
+
+  data_type& value() const { return node_->data_; }
+  template <typename pair_type = data_type>
+  typename pair_type::first_type& key() const {
+    return node_->data_.first;
+  }
+  template <typename pair_type = data_type>
+  typename pair_type::second_type& mapped() const {
+    return node_->data_.second;
+  }
+
+ private:
+  friend class rb_tree;
+  node_handle(node* node_curr, std::shared_ptr<pool_type> pool)
+      : node_(node_curr), pool_(std::move(pool)) {}
+
+  void reset() noexcept {
+    if (node_) {
+      std::destroy_at(std::addressof(node_->data_));
+      node_->~node();
+      pool_type::deallocate(pool_, node_);
+      node_ = nullptr;
+    }
+    pool_.reset();
+  }
+
+  node* node_;
+  std::shared_ptr<pool_type> pool_;
+};
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+struct rb_tree<data_type, compare, allocator, key_of,
+               augment>::insert_return_type {
+  iterator position;
+  bool inserted;
+  node_handle node;
+};
 }  // namespace s21
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::print() const {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::print() const {
   if (!root_) {
     std::cout << "Tree is empty" << std::endl;
     return;
@@ -155,7 +657,7 @@ void s21::rb_tree<data_type, compare>::print() const {
   while (current != nullptr || !s.empty()) {
     while (current != nullptr) {
       s.push(current);
-      current = current->left_;
+      current = current->left();
     }
 
     current = s.top();
@@ -163,99 +665,170 @@ void s21::rb_tree<data_type, compare>::print() const {
 
     std::cout << current->data_ << " ";
 
-    current = current->right_;
+    current = current->right();
   }
   std::cout << std::endl;
 }
 
-template <typename data_type, typename compare>
-bool s21::rb_tree<data_type, compare>::is_balanced_black_height(
-    node* node_curr) const {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+bool
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::is_balanced_black_height(node* node_curr) const {
   if (node_curr == nullptr) return true;
 
-  bool left_balanced = is_balanced_black_height(node_curr->left_);
-  bool right_balanced = is_balanced_black_height(node_curr->right_);
+  bool left_balanced = is_balanced_black_height(node_curr->left());
+  bool right_balanced = is_balanced_black_height(node_curr->right());
 
-  int left_black_height = black_height(node_curr->left_);
-  int right_black_height = black_height(node_curr->right_);
+  int left_black_height = black_height(node_curr->left());
+  int right_black_height = black_height(node_curr->right());
   return left_balanced && right_balanced &&
          (left_black_height == right_black_height);
 }
 
-template <typename data_type, typename compare>
-int s21::rb_tree<data_type, compare>::black_height(node* node_curr) const {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+int s21::rb_tree<data_type, compare, allocator, key_of, augment>::black_height(
+    node* node_curr) const {
   if (node_curr == nullptr) return 0;
-  int left_black_height = black_height(node_curr->left_);
-  int right_black_height = black_height(node_curr->right_);
-  int current_height = (node_curr->color_ == black) ? 1 : 0;
+  int left_black_height = black_height(node_curr->left());
+  int right_black_height = black_height(node_curr->right());
+  int current_height = (node_curr->color() == black) ? 1 : 0;
   return std::max(left_black_height, right_black_height) + current_height;
 }
 
-template <typename data_type, typename compare>
-bool s21::rb_tree<data_type, compare>::is_balanced_red_black(
-    node* node_curr) const {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+bool s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::is_balanced_red_black(node* node_curr) const {
   if (node_curr == nullptr) return true;
-  bool left_balanced = is_balanced_red_black(node_curr->left_);
-  bool right_balanced = is_balanced_red_black(node_curr->right_);
-  if (node_curr->color_ == red) {
-    if (node_curr->left_ && node_curr->left_->color_ != black) return false;
-    if (node_curr->right_ && node_curr->right_->color_ != black) return false;
+  bool left_balanced = is_balanced_red_black(node_curr->left());
+  bool right_balanced = is_balanced_red_black(node_curr->right());
+  if (node_curr->color() == red) {
+    for (const node* child : node_curr->child_) {
+      if (child && child->color() != black) return false;
+    }
   }
   return left_balanced && right_balanced;
 }
 
-template <typename K, typename V>
-s21::rb_tree<K, V>::rb_tree(const rb_tree& other) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::rb_tree(
+    const rb_tree& other)
+    : root_(nullptr),
+      size_(0),
+      compare_(other.compare_),
+      alloc_(other.get_allocator()) {
   if (other.root_) {
+    // размер известен: все узлы копии идут подряд из одного слэба
+    pool_type::reserve(pool(), other.size_);
     root_ = copy_tree(other.root_);
+    header_.left() = min_node(root_);
+    header_.right() = max_node(root_);
     size_ = other.size_;
-    compare_ = other.compare_;
   }
 }
 
-template <typename K, typename V>
-s21::rb_tree<K, V>::rb_tree(rb_tree&& other) noexcept {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::rb_tree(
+    const rb_tree& other, const parallel_options& options)
+    : root_(nullptr),
+      size_(0),
+      compare_(other.compare_),
+      alloc_(other.get_allocator()) {
+  if (other.root_) {
+    size_t threads = other.size_ < options.sequential_cutoff
+                         ? 1
+                         : std::max<size_t>(options.threads, 1);
+    root_ = copy_parallel(other.root_, root_black_height(other.root_), 0,
+                          threads, options);
+    header_.left() = min_node(root_);
+    header_.right() = max_node(root_);
+    size_ = other.size_;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::rb_tree(
+    rb_tree&& other) noexcept
+    : alloc_(other.alloc_), pool_(std::move(other.pool_)) {
   root_ = other.root_;
+  if (root_) {
+    header_.left() = other.header_.left();
+    header_.right() = other.header_.right();
+  }
   size_ = other.size_;
   compare_ = std::move(other.compare_);
   other.root_ = nullptr;
+  other.reset_header();
   other.size_ = 0;
 }
 
-template <typename data_type, typename compare>
-s21::rb_tree<data_type, compare>::rb_tree(
-    std::initializer_list<data_type> const& elem) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::rb_tree(
+    std::initializer_list<data_type> const& elem)
+    : root_(nullptr), size_(0) {
   for (const auto& item : elem) {
     insert_data(item);
   }
 }
 
-template <typename data_type, typename compare>
-s21::rb_tree<data_type, compare>& s21::rb_tree<data_type, compare>::operator=(
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename input_iterator, typename>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::rb_tree(
+    input_iterator first, input_iterator last)
+    : root_(nullptr), size_(0) {
+  assign_range(first, last, true);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>&
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::operator=(
     rb_tree&& other) noexcept {
   if (this != &other) {
     clear();
     root_ = other.root_;
+    if (root_) {
+      header_.left() = other.header_.left();
+      header_.right() = other.header_.right();
+    }
     size_ = other.size_;
     compare_ = other.compare_;
+    alloc_ = other.alloc_;
+    pool_ = std::move(other.pool_);
     other.root_ = nullptr;
+    other.reset_header();
     other.size_ = 0;
   }
   return *this;
 }
 
-template <typename data_type, typename compare>
-data_type& s21::rb_tree<data_type, compare>::iterator::operator*() {
-  if (ptr_) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::value_reference
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator*() {
+  if (ptr_ && ptr_ != &tree_->header_) {
     return ptr_->data_;
   } else {
     static data_type default_value = data_type();
     return default_value;
   }
 }
-template <typename data_type, typename compare>
-const data_type& s21::rb_tree<data_type, compare>::iterator::operator*() const {
-  if (ptr_) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+const data_type&
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator*()
+    const {
+  if (ptr_ && ptr_ != &tree_->header_) {
     return ptr_->data_;
   } else {
     static data_type default_value = data_type();
@@ -263,66 +836,81 @@ const data_type& s21::rb_tree<data_type, compare>::iterator::operator*() const {
   }
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::iterator&
-s21::rb_tree<data_type, compare>::iterator::operator=(const iterator& other) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::iterator&
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator=(const iterator& other) {
   ptr_ = other.ptr_;
   tree_ = other.tree_;
   return *this;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::iterator&
-s21::rb_tree<data_type, compare>::iterator::operator++() {
-  if (ptr_->right_ != nullptr) {
-    ptr_ = tree_->min_node(ptr_->right_);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::iterator&
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator++() {
+  if (ptr_->right() != nullptr) {
+    ptr_ = tree_->min_node(ptr_->right());
   } else {
-    node* parent = ptr_->parent_;
-    while (parent != nullptr && ptr_ == parent->right_) {
+    node* parent = ptr_->parent();
+    while (parent != nullptr && ptr_ == parent->right()) {
       ptr_ = parent;
-      parent = parent->parent_;
+      parent = parent->parent();
     }
-    ptr_ = parent;
+    ptr_ = parent ? parent : &tree_->header_;
   }
   return *this;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::iterator
-s21::rb_tree<data_type, compare>::iterator::operator++(int) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::iterator
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator++(int) {
   iterator temp = *this;
   operator++();
   return temp;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::iterator&
-s21::rb_tree<data_type, compare>::iterator::operator--() {
-  if (ptr_->left_ != nullptr) {
-    ptr_ = tree_->max_node(ptr_->left_);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::iterator&
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator--() {
+  if (ptr_ == &tree_->header_) {
+    ptr_ = tree_->header_.right();
+  } else if (ptr_->left() != nullptr) {
+    ptr_ = tree_->max_node(ptr_->left());
   } else {
-    node* parent = ptr_->parent_;
-    while (parent != nullptr && ptr_ == parent->left_) {
+    node* parent = ptr_->parent();
+    while (parent != nullptr && ptr_ == parent->left()) {
       ptr_ = parent;
-      parent = parent->parent_;
+      parent = parent->parent();
     }
     ptr_ = parent;
   }
   return *this;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::iterator
-s21::rb_tree<data_type, compare>::iterator::operator--(int) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::iterator
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::iterator::operator--(int) {
   iterator temp = *this;
   operator--();
   return temp;
 }
 
-template <typename data_type, typename compare>
-const data_type& s21::rb_tree<data_type, compare>::const_iterator::operator*()
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+const data_type&
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::const_iterator::operator*()
     const {
-  if (ptr_) {
+  if (ptr_ && ptr_ != &tree_->header_) {
     return ptr_->data_;
   } else {
     static const data_type default_value = data_type();
@@ -330,367 +918,1670 @@ const data_type& s21::rb_tree<data_type, compare>::const_iterator::operator*()
   }
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::const_iterator&
-s21::rb_tree<data_type, compare>::const_iterator::operator=(
-    const const_iterator& other) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::const_iterator&
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::const_iterator::operator=(const const_iterator& other) {
   ptr_ = other.ptr_;
   tree_ = other.tree_;
   return *this;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::const_iterator&
-s21::rb_tree<data_type, compare>::const_iterator::operator++() {
-  if (ptr_->right_ != nullptr) {
-    ptr_ = tree_->min_node(ptr_->right_);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::const_iterator&
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::const_iterator::
+operator++() {
+  if (ptr_->right() != nullptr) {
+    ptr_ = tree_->min_node(ptr_->right());
   } else {
-    node* parent = ptr_->parent_;
-    while (parent != nullptr && ptr_ == parent->right_) {
+    node* parent = ptr_->parent();
+    while (parent != nullptr && ptr_ == parent->right()) {
       ptr_ = parent;
-      parent = parent->parent_;
+      parent = parent->parent();
     }
-    ptr_ = parent;
+    ptr_ = parent ? parent : &tree_->header_;
   }
   return *this;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::const_iterator
-s21::rb_tree<data_type, compare>::const_iterator::operator++(int) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::const_iterator
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::const_iterator::
+operator++(int) {
   const_iterator temp = *this;
   operator++();
   return temp;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::const_iterator&
-s21::rb_tree<data_type, compare>::const_iterator::operator--() {
-  if (ptr_->left_ != nullptr) {
-    ptr_ = tree_->max_node(ptr_->left_);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::const_iterator&
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::const_iterator::
+operator--() {
+  if (ptr_ == &tree_->header_) {
+    ptr_ = tree_->header_.right();
+  } else if (ptr_->left() != nullptr) {
+    ptr_ = tree_->max_node(ptr_->left());
   } else {
-    node* parent = ptr_->parent_;
-    while (parent != nullptr && ptr_ == parent->left_) {
+    node* parent = ptr_->parent();
+    while (parent != nullptr && ptr_ == parent->left()) {
       ptr_ = parent;
-      parent = parent->parent_;
+      parent = parent->parent();
     }
     ptr_ = parent;
   }
   return *this;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::const_iterator
-s21::rb_tree<data_type, compare>::const_iterator::operator--(int) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::const_iterator
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::const_iterator::
+operator--(int) {
   const_iterator temp = *this;
   operator--();
   return temp;
 }
 
-template <typename data_type, typename compare>  // ++
-typename s21::rb_tree<data_type, compare>::const_iterator
-s21::rb_tree<data_type, compare>::find(const data_type& value) const {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename other_key>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::find_node(
+    const other_key& key) const {
   node* current = root_;
+  if constexpr (native_order<other_key>) {
+    while (current != nullptr) {
+      int order = three_way(key, node_key(current));
+      if (order == 0) return current;
+      current = current->child_[order > 0];
+    }
+    return nullptr;
+  }
   while (current != nullptr) {
-    if (compare_(value, current->data_)) {
-      current = current->left_;
-    } else if (compare_(current->data_, value)) {
-      current = current->right_;
+    if (compare_(key, node_key(current))) {
+      current = current->left();
+    } else if (compare_(node_key(current), key)) {
+      current = current->right();
+    } else {
+      return current;
+    }
+  }
+  return nullptr;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename other_key>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::lower_node(
+    const other_key& key) const {
+  node* bound = const_cast<node*>(&header_);
+  if constexpr (native_order<other_key>) {
+    for (node* current = root_; current;) {
+      bool right = three_way(key, node_key(current)) > 0;
+      bound = right ? bound : current;
+      current = current->child_[right];
+    }
+    return bound;
+  }
+  for (node* current = root_; current;) {
+    if (compare_(node_key(current), key)) {
+      current = current->right();
     } else {
-      return const_iterator(current, this);
+      bound = current;
+      current = current->left();
     }
   }
-  return cend();
+  return bound;
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::clear() {
-  while (root_ != nullptr) {
-    erase(iterator(root_, this));
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename other_key>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::upper_node(
+    const other_key& key) const {
+  node* bound = const_cast<node*>(&header_);
+  if constexpr (native_order<other_key>) {
+    for (node* current = root_; current;) {
+      bool right = three_way(key, node_key(current)) >= 0;
+      bound = right ? bound : current;
+      current = current->child_[right];
+    }
+    return bound;
+  }
+  for (node* current = root_; current;) {
+    if (compare_(key, node_key(current))) {
+      bound = current;
+      current = current->left();
+    } else {
+      current = current->right();
+    }
   }
-  this->size_ = 0;
+  return bound;
 }
 
-template <typename data_type, typename compare>
-std::pair<typename s21::rb_tree<data_type, compare>::iterator, bool>
-s21::rb_tree<data_type, compare>::insert_data(const data_type& data) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename function>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::visit_range(
+    node* node_curr, const key_type& lo, const key_type& hi,
+    function& fn) const {
+  // в левое поддерево спускаемся, только если ключ узла не меньше lo, в
+  // правое — только если он меньше hi
+  while (node_curr) {
+    bool above_lo = !compare_(node_key(node_curr), lo);
+    bool below_hi = compare_(node_key(node_curr), hi);
+    if (above_lo) visit_range(node_curr->left(), lo, hi, fn);
+    if (above_lo && below_hi) {
+      fn(static_cast<value_reference>(node_curr->data_));
+    }
+    if (!below_hi) return;
+    node_curr = node_curr->right();
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename forward_iterator, typename function>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::find_nodes_batch(forward_iterator first,
+                                             forward_iterator last,
+                                             function&& emit) const {
+  forward_iterator targets[batch_lanes];
+  node* current[batch_lanes];
+  node* found[batch_lanes];
+  while (first != last) {
+    size_t lanes = 0;
+    for (; lanes < batch_lanes && first != last; ++lanes, ++first) {
+      targets[lanes] = first;
+      current[lanes] = root_;
+      found[lanes] = nullptr;
+    }
+    // за один проход каждый спуск делает шаг на уровень вниз; к следующему
+    // проходу запрошенный узел обычно уже в кэше
+    for (bool active = true; active;) {
+      active = false;
+      for (size_t lane = 0; lane < lanes; ++lane) {
+        node* node_curr = current[lane];
+        if (!node_curr) continue;
+        const auto& key = *targets[lane];
+        if (compare_(key, node_key(node_curr))) {
+          node_curr = node_curr->left();
+        } else if (compare_(node_key(node_curr), key)) {
+          node_curr = node_curr->right();
+        } else {
+          found[lane] = node_curr;
+          node_curr = nullptr;
+        }
+        if (node_curr) {
+          prefetch_node(node_curr);
+          active = true;
+        }
+        current[lane] = node_curr;
+      }
+    }
+    for (size_t lane = 0; lane < lanes; ++lane) emit(found[lane]);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::clear() {
+  if (pool_) {
+    // общий пул целиком не освободить: узлы возвращаются в его free list
+    bool released = std::is_trivially_destructible_v<data_type> &&
+                    pool_type::release_if_exclusive(pool_);
+    if (!released) {
+      destroy_subtree(root_);
+      pool_type::release_if_exclusive(pool_);
+    }
+  }
+  root_ = nullptr;
+  reset_header();
+  size_ = 0;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::destroy_subtree(node* node_curr) noexcept {
+  // без стека и рекурсии: левый потомок поворотом поднимается наверх, пока
+  // у текущего узла не останется только правое поддерево
+  while (node_curr) {
+    node* left_child = node_curr->left();
+    if (left_child) {
+      node_curr->left() = left_child->right();
+      left_child->right() = node_curr;
+      node_curr = left_child;
+    } else {
+      node* right_child = node_curr->right();
+      destroy_node(node_curr);
+      node_curr = right_child;
+    }
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+std::pair<typename s21::rb_tree<data_type, compare, allocator,
+                                key_of, augment>::iterator,
+          bool>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::insert_data(
+    const data_type& data) {
+  return insert_value(unique_keys(), data);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename value_arg>
+std::pair<typename s21::rb_tree<data_type, compare, allocator,
+                                key_of, augment>::iterator,
+          bool>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::insert_hint_value(
+    bool unique, const_iterator hint, value_arg&& value) {
+  insert_position position =
+      find_hint_position(hint, key_of()(std::as_const(value)), unique);
+  if (position.existing_) {
+    return std::make_pair(iterator(position.existing_, this), false);
+  }
+  node* new_node =
+      create_node(position.parent_, std::forward<value_arg>(value));
+  link_node(new_node, position);
+  return std::make_pair(iterator(new_node, this), true);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename... Args>
+std::pair<typename s21::rb_tree<data_type, compare, allocator,
+                                key_of, augment>::iterator,
+          bool>
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::emplace_hint_value(
+    bool unique, const_iterator hint, Args&&... args) {
+  if constexpr (sizeof...(Args) == 1 &&
+                (std::is_same_v<std::decay_t<Args>, data_type> && ...)) {
+    // готовое значение: ключ известен до создания узла
+    return insert_hint_value(unique, hint, std::forward<Args>(args)...);
+  } else {
+    node* new_node = create_node(nullptr, std::forward<Args>(args)...);
+    insert_position position =
+        find_hint_position(hint, node_key(new_node), unique);
+    if (position.existing_) {
+      destroy_node(new_node);
+      return std::make_pair(iterator(position.existing_, this), false);
+    }
+    link_node(new_node, position);
+    return std::make_pair(iterator(new_node, this), true);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename other_key>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::insert_position
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::find_insert_position(
+    const other_key& key, bool unique) const {
+  insert_position position{nullptr, false, nullptr};
   node* current_node = root_;
-  node* parent_node = nullptr;
+  if constexpr (native_order<other_key>) {
+    while (current_node != nullptr) {
+      position.parent_ = current_node;
+      int order = three_way(key, node_key(current_node));
+      if (unique && order == 0) {
+        position.existing_ = current_node;
+        return position;
+      }
+      // равный ключ без требования уникальности уходит вправо, как и в
+      // общем спуске ниже
+      position.left_ = order < 0;
+      current_node = current_node->child_[order >= 0];
+    }
+    return position;
+  }
   while (current_node != nullptr) {
-    parent_node = current_node;
-    if (compare_(data, current_node->data_)) {
-      current_node = current_node->left_;
-    } else if (compare_(current_node->data_, data)) {
-      current_node = current_node->right_;
+    position.parent_ = current_node;
+    if (compare_(key, node_key(current_node))) {
+      position.left_ = true;
+      current_node = current_node->left();
+    } else if (unique && !compare_(node_key(current_node), key)) {
+      position.existing_ = current_node;
+      return position;
     } else {
-      return std::make_pair(iterator(current_node, this), false);
+      position.left_ = false;
+      current_node = current_node->right();
     }
   }
-  node* new_node = new node(data, nullptr);
-  new_node->parent_ = parent_node;
-  if (parent_node == nullptr) {
-    root_ = new_node;
-  } else if (!compare_(data, parent_node->data_)) {
-    parent_node->right_ = new_node;
+  return position;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename other_key>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::insert_position
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::find_hint_position(
+    const_iterator hint, const other_key& key, bool unique) const {
+  // подсказка не из этого дерева (в том числе пустая) — обычный спуск
+  if (hint.tree_ != this || root_ == nullptr) {
+    return find_insert_position(key, unique);
+  }
+  // в set соседи должны быть строго меньше/больше ключа, в multiset
+  // допускается равенство
+  node* hint_node = const_cast<node*>(hint.ptr_);
+  node* leftmost = header_.left();
+  node* rightmost = header_.right();
+  if (hint_node == &header_) {
+    // end(): вставка за текущий максимум
+    if (unique ? compare_(node_key(rightmost), key)
+               : !compare_(key, node_key(rightmost))) {
+      return insert_position{rightmost, false, nullptr};
+    }
+  } else if (compare_(key, node_key(hint_node))) {
+    // ключ перед подсказкой: проверяем, что он после предыдущего узла
+    if (hint_node == leftmost) {
+      return insert_position{leftmost, true, nullptr};
+    }
+    iterator prev(hint_node, const_cast<rb_tree*>(this));
+    node* prev_node = (--prev).get_node();
+    if (unique ? compare_(node_key(prev_node), key)
+               : !compare_(key, node_key(prev_node))) {
+      return prev_node->right() == nullptr
+                 ? insert_position{prev_node, false, nullptr}
+                 : insert_position{hint_node, true, nullptr};
+    }
+  } else if (compare_(node_key(hint_node), key) || !unique) {
+    // ключ после подсказки (или равен ей в multiset)
+    if (hint_node == rightmost) {
+      return insert_position{rightmost, false, nullptr};
+    }
+    iterator next(hint_node, const_cast<rb_tree*>(this));
+    node* next_node = (++next).get_node();
+    if (compare_(key, node_key(next_node)) ||
+        (!unique && !compare_(node_key(next_node), key))) {
+      return hint_node->right() == nullptr
+                 ? insert_position{hint_node, false, nullptr}
+                 : insert_position{next_node, true, nullptr};
+    }
+  } else {
+    return insert_position{hint_node, false, hint_node};
+  }
+  return find_insert_position(key, unique);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::link_node(
+    node* new_node, const insert_position& position) {
+  new_node->set_parent(position.parent_);
+  if (position.parent_ == nullptr) {
+    root_ = header_.left() = header_.right() = new_node;
+  } else if (position.left_) {
+    position.parent_->left() = new_node;
+    if (position.parent_ == header_.left()) header_.left() = new_node;
   } else {
-    parent_node->left_ = new_node;
+    position.parent_->right() = new_node;
+    if (position.parent_ == header_.right()) header_.right() = new_node;
   }
+  update_path(new_node);
   fix_violation(new_node);
   ++size_;
-  return std::make_pair(iterator(new_node, this), true);
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::erase(iterator pos) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::erase(iterator pos) {
   node* node_to_delete = pos.get_node();
-  if (!node_to_delete) return;
-  node* replacement_node = node_to_delete;
-  node* child_node = nullptr;
-  if (node_to_delete->left_ && node_to_delete->right_) {
-    replacement_node = min_node(node_to_delete->right_);
+  if (!node_to_delete || node_to_delete == &header_) return;
+  unlink_node(node_to_delete);
+  destroy_node(node_to_delete);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::iterator
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::erase(
+    const_iterator first, const_iterator last) {
+  node* first_node = const_cast<node*>(first.ptr_);
+  node* last_node = const_cast<node*>(last.ptr_);
+  if (first_node == last_node) return iterator(last_node, this);
+  if (first_node == header_.left() && last_node == &header_) {
+    clear();
+    return end();
   }
-  if (replacement_node->left_) {
-    child_node = replacement_node->left_;
-  } else {
-    child_node = replacement_node->right_;
+  size_t erased = 0;
+  for (const_iterator it = first; it != last; ++it) ++erased;
+  size_t total = size_;
+  node* path[max_depth];
+  node* head = root_;
+  size_t head_height = root_black_height(root_);
+  node* tail = nullptr;
+  size_t tail_height = 0;
+  // сначала отрезается хвост от last: путь к first считается уже в
+  // оставшейся части, где родители снова корректны
+  if (last_node != &header_) {
+    path_to(last_node, path);
+    split_before(root_, head_height, path, last_node, head, head_height, tail,
+                 tail_height);
   }
-  if (child_node) {
-    child_node->parent_ = replacement_node->parent_;
+  node* middle = head;
+  size_t middle_height = head_height;
+  head = nullptr;
+  head_height = 0;
+  if (first_node != header_.left()) {
+    path_to(first_node, path);
+    split_before(middle, middle_height, path, first_node, head, head_height,
+                 middle, middle_height);
   }
-  if (!replacement_node->parent_) {
-    root_ = child_node;
-  } else if (replacement_node == replacement_node->parent_->left_) {
-    replacement_node->parent_->left_ = child_node;
-  } else {
-    replacement_node->parent_->right_ = child_node;
+  destroy_subtree(middle);
+  size_t height = 0;
+  node* joined = join_two(head, head_height, tail, tail_height, height);
+  attach_root(joined, total - erased);
+  return iterator(last_node, this);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::path_to(
+    node* node_curr, node** path) noexcept {
+  size_t depth = 0;
+  for (node* up = node_curr; up; up = up->parent()) ++depth;
+  for (size_t i = depth; i > 0; node_curr = node_curr->parent()) {
+    path[--i] = node_curr;
   }
-  if (replacement_node != node_to_delete) {
-    node_to_delete->data_ = replacement_node->data_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::split_before(
+    node* node_curr, size_t height, node* const* path, node* boundary,
+    node*& left, size_t& left_height, node*& right, size_t& right_height) {
+  // устроено как split_node, только сторону выбирает путь, а не ключ:
+  // так разрез проходит и между равными ключами multiset
+  size_t child_height = height - (node_curr->color() == black ? 1 : 0);
+  node* left_child = node_curr->left();
+  node* right_child = node_curr->right();
+  if (left_child) left_child->set_parent(nullptr);
+  if (right_child) right_child->set_parent(nullptr);
+  node* rest = nullptr;
+  size_t rest_height = 0;
+  if (node_curr == boundary) {
+    left = left_child;
+    left_height = child_height;
+    right = join_roots(nullptr, 0, node_curr, right_child, child_height,
+                       right_height);
+  } else if (path[1] == left_child) {
+    split_before(left_child, child_height, path + 1, boundary, left,
+                 left_height, rest, rest_height);
+    right = join_roots(rest, rest_height, node_curr, right_child,
+                       child_height, right_height);
+  } else {
+    split_before(right_child, child_height, path + 1, boundary, rest,
+                 rest_height, right, right_height);
+    left = join_roots(left_child, child_height, node_curr, rest, rest_height,
+                      left_height);
   }
+}
 
-  if (replacement_node->color_ == black && child_node) {
-    delete_fix(child_node);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::unlink_node(
+    node* node_to_delete) {
+  // у крайних узлов нет внешнего потомка, соседа находим до перестройки
+  if (node_to_delete == header_.left()) {
+    header_.left() = node_to_delete->right() ? min_node(node_to_delete->right())
+                                           : node_to_delete->parent();
+  }
+  if (node_to_delete == header_.right()) {
+    header_.right() = node_to_delete->left() ? max_node(node_to_delete->left())
+                                           : node_to_delete->parent();
+  }
+  node* replacement_node = node_to_delete;
+  color_node removed_color = replacement_node->color();
+  node* child_node = nullptr;
+  node* child_parent = nullptr;
+  if (!node_to_delete->left()) {
+    child_node = node_to_delete->right();
+    child_parent = node_to_delete->parent();
+    transplant(node_to_delete, child_node);
+  } else if (!node_to_delete->right()) {
+    child_node = node_to_delete->left();
+    child_parent = node_to_delete->parent();
+    transplant(node_to_delete, child_node);
+  } else {
+    replacement_node = min_node(node_to_delete->right());
+    removed_color = replacement_node->color();
+    child_node = replacement_node->right();
+    if (replacement_node->parent() == node_to_delete) {
+      child_parent = replacement_node;
+    } else {
+      child_parent = replacement_node->parent();
+      transplant(replacement_node, child_node);
+      replacement_node->right() = node_to_delete->right();
+      replacement_node->right()->set_parent(replacement_node);
+    }
+    transplant(node_to_delete, replacement_node);
+    replacement_node->left() = node_to_delete->left();
+    replacement_node->left()->set_parent(replacement_node);
+    replacement_node->set_color(node_to_delete->color());
+  }
+  update_path(child_parent);
+  if (removed_color == black) {
+    delete_fix(child_node, child_parent);
   }
-  delete replacement_node;
   --size_;
+  if (!root_) reset_header();
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::swap(rb_tree& other) noexcept {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::swap(
+    rb_tree& other) noexcept {
   std::swap(root_, other.root_);
+  std::swap(header_.left(), other.header_.left());
+  std::swap(header_.right(), other.header_.right());
+  if (!root_) reset_header();
+  if (!other.root_) other.reset_header();
   std::swap(size_, other.size_);
   std::swap(compare_, other.compare_);
+  std::swap(alloc_, other.alloc_);
+  pool_.swap(other.pool_);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::merge(
+    rb_tree& other) {
+  // узлы перецепляются без копирования; ключи, которые уже есть в set/map,
+  // остаются в other
+  if (this == &other || !other.root_) return;
+  adopt_pool(other.pool_);
+  bool unique = unique_keys();
+  node* current = other.header_.left();
+  while (current != &other.header_) {
+    iterator next(current, &other);
+    ++next;
+    insert_position position = find_insert_position(node_key(current), unique);
+    if (!position.existing_) {
+      other.unlink_node(current);
+      current->left() = current->right() = nullptr;
+      current->set_color(red);
+      link_node(current, position);
+    }
+    current = next.get_node();
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::node_handle
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::extract(
+    const_iterator pos) {
+  node* node_curr = const_cast<node*>(pos.ptr_);
+  if (!node_curr || node_curr == &header_) return node_handle();
+  unlink_node(node_curr);
+  // handle может вернуть узел в пул из другого потока
+  pool_type::share(pool_);
+  return node_handle(node_curr, pool_);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+std::pair<typename s21::rb_tree<data_type, compare, allocator,
+                                key_of, augment>::iterator,
+          bool>
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::insert_handle(
+    bool unique, const_iterator hint, node_handle& handle) {
+  if (handle.empty()) return std::make_pair(end(), false);
+  node* node_curr = handle.node_;
+  insert_position position =
+      find_hint_position(hint, node_key(node_curr), unique);
+  if (position.existing_) {
+    return std::make_pair(iterator(position.existing_, this), false);
+  }
+  adopt_pool(std::move(handle.pool_));
+  node_curr->left() = node_curr->right() = nullptr;
+  node_curr->set_color(red);
+  link_node(node_curr, position);
+  handle.node_ = nullptr;
+  return std::make_pair(iterator(node_curr, this), true);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::adopt_pool(
+    std::shared_ptr<pool_type>& other_pool) {
+  if (!other_pool) return;
+  if (!pool_) {
+    pool_ = other_pool;
+    pool_type::share(pool_);
+  } else {
+    pool_type::unite(pool_, other_pool);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::adopt_pool(
+    std::shared_ptr<pool_type>&& other_pool) {
+  if (!pool_) {
+    pool_ = std::move(other_pool);
+  } else {
+    pool_type::splice(pool_, std::move(other_pool));
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename... Args>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::create_node(
+    node* parent, Args&&... args) {
+  node* new_node = pool_type::allocate(pool());
+  try {
+    ::new (static_cast<void*>(new_node))
+        node(parent, std::forward<Args>(args)...);
+  } catch (...) {
+    pool_type::deallocate(pool_, new_node);
+    throw;
+  }
+  return new_node;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::destroy_node(
+    node* node_curr) noexcept {
+  std::destroy_at(std::addressof(node_curr->data_));
+  node_curr->~node();
+  pool_type::deallocate(pool_, node_curr);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename input_iterator>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::assign_range(
+    input_iterator first, input_iterator last, bool unique) {
+  using category =
+      typename std::iterator_traits<input_iterator>::iterator_category;
+  if constexpr (!std::is_base_of_v<std::forward_iterator_tag, category>) {
+    std::vector<data_type> buffer(first, last);
+    assign_range(buffer.begin(), buffer.end(), unique);
+  } else {
+    // один проход: проверяем упорядоченность и считаем будущие узлы
+    bool sorted = true;
+    size_t count = 0;
+    for (input_iterator prev = first, it = first; it != last; prev = it++) {
+      if (it == first) {
+        ++count;
+      } else if (compare_(key_of()(*it), key_of()(*prev))) {
+        sorted = false;
+        break;
+      } else if (!unique || compare_(key_of()(*prev), key_of()(*it))) {
+        ++count;
+      }
+    }
+    if (!sorted) {
+      std::vector<data_type> buffer(first, last);
+      std::stable_sort(buffer.begin(), buffer.end(),
+                       [this](const data_type& lhs, const data_type& rhs) {
+                         return compare_(key_of()(lhs), key_of()(rhs));
+                       });
+      assign_range(buffer.begin(), buffer.end(), unique);
+      return;
+    }
+    size_t red_depth = 0;
+    while ((size_t(2) << red_depth) <= count + 1) ++red_depth;
+    node* new_root = build_sorted(first, last, count, 0, red_depth, unique);
+    destroy_subtree(root_);
+    root_ = new_root;
+    if (root_) {
+      header_.left() = min_node(root_);
+      header_.right() = max_node(root_);
+    } else {
+      reset_header();
+    }
+    size_ = count;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename forward_iterator>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::build_sorted(
+    forward_iterator& first, forward_iterator last, size_t count,
+    size_t depth, size_t red_depth, bool unique) {
+  // узлы создаются в порядке обхода in-order, поэтому соседние по ключу
+  // элементы оказываются рядом и в слэбах пула
+  if (count == 0) return nullptr;
+  size_t left_count = (count - 1) / 2;
+  node* left_child =
+      build_sorted(first, last, left_count, depth + 1, red_depth, unique);
+  node* current = nullptr;
+  try {
+    current = create_node(nullptr, *first);
+  } catch (...) {
+    destroy_subtree(left_child);
+    throw;
+  }
+  forward_iterator value = first;
+  ++first;
+  while (unique && first != last &&
+         !compare_(key_of()(*value), key_of()(*first))) {
+    ++first;
+  }
+  current->set_color(depth >= red_depth ? red : black);
+  current->left() = left_child;
+  if (left_child) left_child->set_parent(current);
+  try {
+    current->right() = build_sorted(first, last, count - 1 - left_count,
+                                   depth + 1, red_depth, unique);
+  } catch (...) {
+    destroy_subtree(current);
+    throw;
+  }
+  if (current->right()) current->right()->set_parent(current);
+  augment::update(current);
+  return current;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of,
+                      augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::nth_node(
+    size_t index) const {
+  static_assert(counts_nodes<augment>::value,
+                "nth() requires the subtree_size augmentation");
+  node* current = root_;
+  while (current != nullptr) {
+    size_t left_count = augment::count(current->left());
+    if (index < left_count) {
+      current = current->left();
+    } else if (index == left_count) {
+      return current;
+    } else {
+      index -= left_count + 1;
+      current = current->right();
+    }
+  }
+  return const_cast<node*>(&header_);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename policy>
+typename policy::value_type
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::aggregate(
+    const key_type& lo, const key_type& hi) const {
+  static_assert(std::is_same_v<policy, augment> &&
+                    aggregates_values<policy>::value,
+                "aggregate() requires a monoid_augment policy");
+  // спуск до первого узла внутри [lo, hi): в нём пути к lo и hi
+  // расходятся
+  node* split = root_;
+  while (split) {
+    if (compare_(node_key(split), lo)) {
+      split = split->right();
+    } else if (!compare_(node_key(split), hi)) {
+      split = split->left();
+    } else {
+      break;
+    }
+  }
+  if (!split) return policy::identity();
+  // на пути к lo узел не меньше lo входит вместе с правым поддеревом,
+  // на пути к hi узел меньше hi — вместе с левым; порядок сохраняется,
+  // так что combine не обязана быть коммутативной
+  typename policy::value_type left_part = policy::identity();
+  for (node* current = split->left(); current;) {
+    if (compare_(node_key(current), lo)) {
+      current = current->right();
+    } else {
+      left_part = policy::combine(
+          policy::combine(policy::lift(current->data_),
+                          policy::of(current->right())),
+          left_part);
+      current = current->left();
+    }
+  }
+  typename policy::value_type right_part = policy::identity();
+  for (node* current = split->right(); current;) {
+    if (compare_(node_key(current), hi)) {
+      right_part = policy::combine(
+          right_part, policy::combine(policy::of(current->left()),
+                                      policy::lift(current->data_)));
+      current = current->right();
+    } else {
+      current = current->left();
+    }
+  }
+  return policy::combine(
+      policy::combine(left_part, policy::lift(split->data_)), right_part);
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::merge(rb_tree& other) {
-  if (this == &other) return;
-  for (auto it = other.begin(); it != other.end(); ++it) {
-    insert_data(*it);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+size_t s21::rb_tree<data_type, compare, allocator, key_of, augment>::rank(
+    const key_type& key) const {
+  static_assert(counts_nodes<augment>::value,
+                "rank() requires the subtree_size augmentation");
+  // число элементов строго меньше key
+  size_t result = 0;
+  node* current = root_;
+  while (current != nullptr) {
+    if (compare_(node_key(current), key)) {
+      result += augment::count(current->left()) + 1;
+      current = current->right();
+    } else {
+      current = current->left();
+    }
   }
-  other.clear();
+  return result;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::node*
-s21::rb_tree<data_type, compare>::copy_tree(node* src) {
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of,
+             augment>::copy_tree(node* src) {
   if (src == nullptr) {
     return nullptr;
   }
   std::stack<node*> src_stack, copy_stack;
   src_stack.push(src);
-  node* new_root = new node(src->data_, nullptr);
+  node* new_root = create_node(nullptr, src->data_);
+  copy_node_state(new_root, src);
   copy_stack.push(new_root);
-  while (!src_stack.empty()) {
-    node* src_node = src_stack.top();
-    node* copy_node = copy_stack.top();
-    src_stack.pop();
-    copy_stack.pop();
-    if (src_node->right_ != nullptr) {
-      copy_node->right_ = new node(src_node->right_->data_, copy_node);
-      copy_stack.push(copy_node->right_);
-      src_stack.push(src_node->right_);
-    }
-    if (src_node->left_ != nullptr) {
-      copy_node->left_ = new node(src_node->left_->data_, copy_node);
-      copy_stack.push(copy_node->left_);
-      src_stack.push(src_node->left_);
+  // при исключении уничтожается всё, что уже подвешено к new_root
+  try {
+    while (!src_stack.empty()) {
+      node* src_node = src_stack.top();
+      node* copy_node = copy_stack.top();
+      src_stack.pop();
+      copy_stack.pop();
+      if (src_node->right() != nullptr) {
+        copy_node->right() = create_node(copy_node, src_node->right()->data_);
+        copy_node_state(copy_node->right(), src_node->right());
+        copy_stack.push(copy_node->right());
+        src_stack.push(src_node->right());
+      }
+      if (src_node->left() != nullptr) {
+        copy_node->left() = create_node(copy_node, src_node->left()->data_);
+        copy_node_state(copy_node->left(), src_node->left());
+        copy_stack.push(copy_node->left());
+        src_stack.push(src_node->left());
+      }
     }
+  } catch (...) {
+    destroy_subtree(new_root);
+    throw;
   }
   return new_root;
 }
 
-template <typename data_type, typename compare>  // ++
-typename s21::rb_tree<data_type, compare>::iterator
-s21::rb_tree<data_type, compare>::find(const data_type& value) {
-  node* current = root_;
-  while (current != nullptr) {
-    if (compare_(value, current->data_)) {
-      current = current->left_;
-    } else if (compare_(current->data_, value)) {
-      current = current->right_;
-    } else {
-      return iterator(current, this);
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::copy_parallel(
+    node* src, size_t height, size_t depth, size_t threads,
+    const parallel_options& options) {
+  if (!src) return nullptr;
+  if (threads < 2 || depth >= options.fork_depth ||
+      estimate_size(src, height) < options.sequential_cutoff) {
+    pool_type::reserve(pool(), subtree_nodes(src));
+    return copy_tree(src);
+  }
+  size_t child_height = height - (src->color() == black ? 1 : 0);
+  // у потока своё дерево и свой пул: пул не потокобезопасен, а после
+  // завершения потока его слэбы переходят в пул этого дерева
+  size_t forked_threads = threads / 2;
+  std::shared_ptr<pool_type> forked_pool;
+  std::future<node*> forked = std::async(std::launch::async, [&] {
+    rb_tree scratch(alloc_);
+    scratch.compare_ = compare_;
+    node* result = scratch.copy_parallel(src->left(), child_height, depth + 1,
+                                         forked_threads, options);
+    forked_pool = std::move(scratch.pool_);
+    return result;
+  });
+  node* copy = nullptr;
+  node* forked_copy = nullptr;
+  try {
+    copy = create_node(nullptr, src->data_);
+    copy_node_state(copy, src);
+    copy->right() = copy_parallel(src->right(), child_height, depth + 1,
+                                  threads - forked_threads, options);
+  } catch (...) {
+    // поток мог уже скопировать своё поддерево: дожидаемся его, забираем
+    // пул и уничтожаем обе части
+    try {
+      forked_copy = forked.get();
+    } catch (...) {
     }
+    adopt_pool(std::move(forked_pool));
+    destroy_subtree(forked_copy);
+    destroy_subtree(copy);
+    throw;
+  }
+  try {
+    forked_copy = forked.get();
+  } catch (...) {
+    destroy_subtree(copy);
+    throw;
   }
-  return end();
+  adopt_pool(std::move(forked_pool));
+  copy->left() = forked_copy;
+  if (copy->left()) copy->left()->set_parent(copy);
+  if (copy->right()) copy->right()->set_parent(copy);
+  return copy;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::node*
-s21::rb_tree<data_type, compare>::max_node(node* node_curr) const {
-  while (node_curr->right_ != nullptr) {
-    node_curr = node_curr->right_;
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+size_t s21::rb_tree<data_type, compare, allocator, key_of,
+                    augment>::subtree_nodes(const node* node_curr) {
+  if constexpr (counts_nodes<augment>::value) {
+    return augment::count(node_curr);
+  } else {
+    size_t count = 0;
+    std::vector<const node*> pending;
+    if (node_curr) pending.push_back(node_curr);
+    while (!pending.empty()) {
+      const node* top = pending.back();
+      pending.pop_back();
+      ++count;
+      if (top->left()) pending.push_back(top->left());
+      if (top->right()) pending.push_back(top->right());
+    }
+    return count;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::split_into(
+    const key_type& key, rb_tree& left, rb_tree& right) {
+  // ключи меньше key уходят в left, остальные — в right
+  left.clear();
+  right.clear();
+  left.compare_ = right.compare_ = compare_;
+  if (!root_) return;
+  // половины делят один пул и могут жить в разных потоках
+  left.adopt_pool(pool_);
+  right.adopt_pool(std::move(pool_));
+  size_t total = size_;
+  node* left_root = nullptr;
+  node* right_root = nullptr;
+  size_t left_height = 0;
+  size_t right_height = 0;
+  split_node(root_, root_black_height(root_), key, left_root, left_height,
+             right_root, right_height);
+  detach_nodes();
+  left.attach_root(left_root, 0);
+  right.attach_root(right_root, 0);
+  if constexpr (counts_nodes<augment>::value) {
+    left.size_ = augment::count(left_root);
+    right.size_ = augment::count(right_root);
+  } else {
+    // без размеров поддеревьев обходим обе части до конца меньшей: split
+    // стоит O(log n + min(|left|, |right|)), а O(log n) он даёт только с
+    // политикой subtree_size
+    iterator left_it = left.begin();
+    iterator right_it = right.begin();
+    size_t steps = 0;
+    for (; left_it != left.end() && right_it != right.end(); ++steps) {
+      ++left_it;
+      ++right_it;
+    }
+    bool left_done = left_it == left.end();
+    left.size_ = left_done ? steps : total - steps;
+    right.size_ = left_done ? total - steps : steps;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::split_node(
+    node* node_curr, size_t height, const key_type& key, node*& left,
+    size_t& left_height, node*& right, size_t& right_height) {
+  if (!node_curr) {
+    left = right = nullptr;
+    left_height = right_height = 0;
+    return;
+  }
+  // height — чёрная высота node_curr, у детей она меньше на его цвет
+  size_t child_height = height - (node_curr->color() == black ? 1 : 0);
+  node* left_child = node_curr->left();
+  node* right_child = node_curr->right();
+  if (left_child) left_child->set_parent(nullptr);
+  if (right_child) right_child->set_parent(nullptr);
+  node* rest = nullptr;
+  size_t rest_height = 0;
+  if (compare_(node_key(node_curr), key)) {
+    split_node(right_child, child_height, key, rest, rest_height, right,
+               right_height);
+    left = join_roots(left_child, child_height, node_curr, rest, rest_height,
+                      left_height);
+  } else {
+    split_node(left_child, child_height, key, left, left_height, rest,
+               rest_height);
+    right = join_roots(rest, rest_height, node_curr, right_child,
+                       child_height, right_height);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::join_trees(
+    rb_tree& left, rb_tree& right) {
+  clear();
+  compare_ = left.compare_;
+  if (left.root_ && right.root_) {
+    const key_type& left_max = node_key(left.header_.right());
+    const key_type& right_min = node_key(right.header_.left());
+    if (unique_keys() ? !compare_(left_max, right_min)
+                      : compare_(right_min, left_max)) {
+      throw std::invalid_argument("rb_tree::join: key ranges overlap");
+    }
+    // опорным узлом становится минимум правого дерева
+    node* pivot = right.header_.left();
+    right.unlink_node(pivot);
+    join_trees(left, pivot, right);
+  } else {
+    rb_tree& source = left.root_ ? left : right;
+    adopt_pool(std::move(source.pool_));
+    attach_root(source.root_, source.size_);
+    source.detach_nodes();
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+template <typename... Args>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::join_trees_with(
+    rb_tree& left, rb_tree& right, Args&&... pivot_args) {
+  clear();
+  compare_ = left.compare_;
+  node* pivot = create_node(nullptr, std::forward<Args>(pivot_args)...);
+  if (!pivot_fits(left, pivot, right)) {
+    destroy_node(pivot);
+    throw std::invalid_argument("rb_tree::join: pivot breaks key order");
+  }
+  join_trees(left, pivot, right);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+bool s21::rb_tree<data_type, compare, allocator, key_of, augment>::pivot_fits(
+    const rb_tree& left, const node* pivot, const rb_tree& right) const {
+  // при уникальных ключах равенство с pivot тоже запрещено
+  const key_type& key = node_key(pivot);
+  if (unique_keys()) {
+    return (!left.root_ || compare_(node_key(left.header_.right()), key)) &&
+           (!right.root_ || compare_(key, node_key(right.header_.left())));
+  }
+  return (!left.root_ || !compare_(key, node_key(left.header_.right()))) &&
+         (!right.root_ || !compare_(node_key(right.header_.left()), key));
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::join_trees(
+    rb_tree& left, node* pivot, rb_tree& right) {
+  adopt_pool(std::move(left.pool_));
+  adopt_pool(std::move(right.pool_));
+  node* left_root = left.root_;
+  node* right_root = right.root_;
+  node* leftmost = left_root ? left.header_.left() : pivot;
+  node* rightmost = right_root ? right.header_.right() : pivot;
+  size_t count = left.size_ + right.size_ + 1;
+  left.detach_nodes();
+  right.detach_nodes();
+  size_t height = 0;
+  join_roots(left_root, root_black_height(left_root), pivot, right_root,
+             root_black_height(right_root), height);
+  size_ = count;
+  header_.left() = leftmost;
+  header_.right() = rightmost;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::join_roots(
+    node* left, size_t left_height, node* pivot, node* right,
+    size_t right_height, size_t& height) {
+  // красные корни перекрашиваются, чтобы pivot можно было сделать красным
+  if (left && left->color() == red) {
+    left->set_color(black);
+    ++left_height;
+  }
+  if (right && right->color() == red) {
+    right->set_color(black);
+    ++right_height;
+  }
+  if (left_height == right_height) {
+    pivot->left() = left;
+    pivot->right() = right;
+    pivot->set_parent(nullptr);
+    if (left) left->set_parent(pivot);
+    if (right) right->set_parent(pivot);
+    pivot->set_color(black);
+    augment::update(pivot);
+    root_ = pivot;
+    height = left_height + 1;
+    return root_;
+  }
+  // спуск по краю более высокого дерева до чёрного узла той же высоты,
+  // что у низкого; pivot встаёт на его место красным
+  bool left_taller = left_height > right_height;
+  node* current = left_taller ? left : right;
+  size_t current_height = left_taller ? left_height : right_height;
+  size_t target_height = left_taller ? right_height : left_height;
+  node* parent = nullptr;
+  while (!(is_black(current) && current_height == target_height)) {
+    if (current->color() == black) --current_height;
+    parent = current;
+    current = left_taller ? current->right() : current->left();
+  }
+  pivot->set_color(red);
+  pivot->set_parent(parent);
+  if (left_taller) {
+    pivot->left() = current;
+    pivot->right() = right;
+    parent->right() = pivot;
+    if (right) right->set_parent(pivot);
+  } else {
+    pivot->left() = left;
+    pivot->right() = current;
+    parent->left() = pivot;
+    if (left) left->set_parent(pivot);
+  }
+  if (current) current->set_parent(pivot);
+  root_ = left_taller ? left : right;
+  update_path(pivot);
+  height = (left_taller ? left_height : right_height) +
+           (fix_violation(pivot) ? 1 : 0);
+  return root_;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+size_t s21::rb_tree<data_type, compare, allocator, key_of,
+                    augment>::root_black_height(
+    const node* node_curr) noexcept {
+  size_t height = 0;
+  for (; node_curr; node_curr = node_curr->left()) {
+    if (node_curr->color() == black) ++height;
+  }
+  return height;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::attach_root(
+    node* new_root, size_t count) {
+  root_ = new_root;
+  size_ = count;
+  if (root_) {
+    root_->set_parent(nullptr);
+    root_->set_color(black);
+    header_.left() = min_node(root_);
+    header_.right() = max_node(root_);
+  } else {
+    reset_header();
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::combine_trees(rb_tree& left, rb_tree& right,
+                                          set_operation operation,
+                                          const parallel_options& options) {
+  clear();
+  compare_ = left.compare_;
+  adopt_pool(std::move(left.pool_));
+  adopt_pool(std::move(right.pool_));
+  size_t total = left.size_ + right.size_;
+  node* left_root = left.root_;
+  node* right_root = right.root_;
+  left.detach_nodes();
+  right.detach_nodes();
+  size_t threads = total < options.sequential_cutoff
+                       ? 1
+                       : std::max<size_t>(options.threads, 1);
+  combine_context context{operation, unique_keys(),
+                          options.sequential_cutoff};
+  std::vector<node*> discarded;
+  size_t height = 0;
+  node* result = combine_nodes(left_root, root_black_height(left_root),
+                               right_root, root_black_height(right_root),
+                               height, context, threads, discarded);
+  attach_root(result, total - discarded.size());
+  for (node* node_curr : discarded) destroy_node(node_curr);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::combine_nodes(
+    node* left, size_t left_height, node* right, size_t right_height,
+    size_t& height, const combine_context& context, size_t threads,
+    std::vector<node*>& discarded) {
+  if (!left || !right) {
+    node* rest = left ? left : right;
+    bool keep = context.operation_ == set_operation::union_of ||
+                (context.operation_ == set_operation::difference_of && left);
+    height = keep ? (left ? left_height : right_height) : 0;
+    if (keep) return rest;
+    collect_nodes(rest, discarded);
+    return nullptr;
+  }
+  // корень right делит оба дерева на меньшие, равные и большие ключи;
+  // меньшие и большие части обрабатываются независимо
+  const key_type& key = node_key(right);
+  node* left_less = nullptr;
+  node* left_greater = nullptr;
+  node* right_less = nullptr;
+  node* right_greater = nullptr;
+  size_t left_less_height = 0;
+  size_t left_greater_height = 0;
+  size_t right_less_height = 0;
+  size_t right_greater_height = 0;
+  std::vector<node*> left_equal;
+  std::vector<node*> right_equal;
+  split_equal(left, left_height, key, context.unique_, left_less,
+              left_less_height, left_equal, left_greater,
+              left_greater_height);
+  split_equal(right, right_height, key, context.unique_, right_less,
+              right_less_height, right_equal, right_greater,
+              right_greater_height);
+
+  node* less = nullptr;
+  node* greater = nullptr;
+  size_t less_height = 0;
+  size_t greater_height = 0;
+  size_t less_size = estimate_size(left_less, left_less_height) +
+                     estimate_size(right_less, right_less_height);
+  if (threads > 1 && less_size >= context.cutoff_) {
+    // меньшие ключи уходят в отдельный поток со своим деревом: повороты
+    // переписывают root_, поэтому this у потоков должен быть разный
+    size_t forked_threads = threads / 2;
+    std::vector<node*> forked_discarded;
+    std::future<node*> forked = std::async(std::launch::async, [&] {
+      rb_tree scratch;
+      scratch.compare_ = compare_;
+      node* result = scratch.combine_nodes(
+          left_less, left_less_height, right_less, right_less_height,
+          less_height, context, forked_threads, forked_discarded);
+      scratch.root_ = nullptr;
+      return result;
+    });
+    greater = combine_nodes(left_greater, left_greater_height, right_greater,
+                            right_greater_height, greater_height, context,
+                            threads - forked_threads, discarded);
+    less = forked.get();
+    discarded.insert(discarded.end(), forked_discarded.begin(),
+                     forked_discarded.end());
+  } else {
+    less = combine_nodes(left_less, left_less_height, right_less,
+                         right_less_height, less_height, context, threads,
+                         discarded);
+    greater = combine_nodes(left_greater, left_greater_height, right_greater,
+                            right_greater_height, greater_height, context,
+                            threads, discarded);
+  }
+
+  // из равных ключей остаются: при объединении — максимум из двух кратностей
+  // (сначала узлы left), при пересечении — минимум, при разности — остаток
+  size_t common = std::min(left_equal.size(), right_equal.size());
+  std::vector<node*> middle;
+  if (context.operation_ == set_operation::union_of) {
+    middle = left_equal;
+    middle.insert(middle.end(), right_equal.begin() + common,
+                  right_equal.end());
+    discarded.insert(discarded.end(), right_equal.begin(),
+                     right_equal.begin() + common);
+  } else {
+    auto kept = context.operation_ == set_operation::intersection_of
+                    ? std::make_pair(left_equal.begin(),
+                                     left_equal.begin() + common)
+                    : std::make_pair(left_equal.begin() + common,
+                                     left_equal.end());
+    middle.assign(kept.first, kept.second);
+    discarded.insert(discarded.end(), left_equal.begin(), kept.first);
+    discarded.insert(discarded.end(), kept.second, left_equal.end());
+    discarded.insert(discarded.end(), right_equal.begin(), right_equal.end());
+  }
+  if (middle.empty()) {
+    return join_two(less, less_height, greater, greater_height, height);
+  }
+  for (size_t i = 0; i + 1 < middle.size(); ++i) {
+    less = join_roots(less, less_height, middle[i], nullptr, 0, less_height);
+  }
+  return join_roots(less, less_height, middle.back(), greater, greater_height,
+                    height);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::split_equal(
+    node* node_curr, size_t height, const key_type& key, bool unique,
+    node*& left, size_t& left_height, std::vector<node*>& equal, node*& right,
+    size_t& right_height) {
+  if (!node_curr) {
+    left = right = nullptr;
+    left_height = right_height = 0;
+    return;
+  }
+  size_t child_height = height - (node_curr->color() == black ? 1 : 0);
+  node* left_child = node_curr->left();
+  node* right_child = node_curr->right();
+  if (left_child) left_child->set_parent(nullptr);
+  if (right_child) right_child->set_parent(nullptr);
+  node* rest = nullptr;
+  size_t rest_height = 0;
+  if (compare_(node_key(node_curr), key)) {
+    split_equal(right_child, child_height, key, unique, rest, rest_height,
+                equal, right, right_height);
+    left = join_roots(left_child, child_height, node_curr, rest, rest_height,
+                      left_height);
+  } else if (compare_(key, node_key(node_curr))) {
+    split_equal(left_child, child_height, key, unique, left, left_height,
+                equal, rest, rest_height);
+    right = join_roots(rest, rest_height, node_curr, right_child,
+                       child_height, right_height);
+  } else if (unique) {
+    left = left_child;
+    right = right_child;
+    left_height = right_height = child_height;
+    equal.push_back(node_curr);
+  } else {
+    // дубликаты могут лежать в обоих поддеревьях; rest остаётся пустым
+    split_equal(left_child, child_height, key, unique, left, left_height,
+                equal, rest, rest_height);
+    equal.push_back(node_curr);
+    split_equal(right_child, child_height, key, unique, rest, rest_height,
+                equal, right, right_height);
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::join_two(
+    node* left, size_t left_height, node* right, size_t right_height,
+    size_t& height) {
+  if (!left || !right) {
+    height = left ? left_height : right_height;
+    return left ? left : right;
+  }
+  // без опорного узла им становится максимум left
+  node* last = nullptr;
+  size_t rest_height = 0;
+  node* rest = split_last(left, left_height, last, rest_height);
+  return join_roots(rest, rest_height, last, right, right_height, height);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::split_last(
+    node* node_curr, size_t height, node*& last, size_t& rest_height) {
+  size_t child_height = height - (node_curr->color() == black ? 1 : 0);
+  node* left_child = node_curr->left();
+  node* right_child = node_curr->right();
+  if (left_child) left_child->set_parent(nullptr);
+  if (right_child) right_child->set_parent(nullptr);
+  if (!right_child) {
+    last = node_curr;
+    rest_height = child_height;
+    return left_child;
+  }
+  size_t tail_height = 0;
+  node* tail = split_last(right_child, child_height, last, tail_height);
+  return join_roots(left_child, child_height, node_curr, tail, tail_height,
+                    rest_height);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::collect_nodes(node* node_curr,
+                                          std::vector<node*>& nodes) {
+  if (!node_curr) return;
+  collect_nodes(node_curr->left(), nodes);
+  nodes.push_back(node_curr);
+  collect_nodes(node_curr->right(), nodes);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+size_t s21::rb_tree<data_type, compare, allocator, key_of,
+                    augment>::estimate_size(const node* node_curr,
+                                            size_t height) noexcept {
+  // без размеров поддеревьев хватает нижней оценки по чёрной высоте
+  if constexpr (counts_nodes<augment>::value) {
+    return augment::count(node_curr);
+  } else {
+    return node_curr ? (size_t(1) << height) - 1 : 0;
+  }
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::max_node(
+    node* node_curr) const {
+  while (node_curr->right() != nullptr) {
+    node_curr = node_curr->right();
   }
   return node_curr;
 }
 
-template <typename data_type, typename compare>
-typename s21::rb_tree<data_type, compare>::node*
-s21::rb_tree<data_type, compare>::min_node(node* node_curr) const {
-  while (node_curr->left_ != nullptr) {
-    node_curr = node_curr->left_;
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+typename s21::rb_tree<data_type, compare, allocator, key_of, augment>::node*
+s21::rb_tree<data_type, compare, allocator, key_of, augment>::min_node(
+    node* node_curr) const {
+  while (node_curr->left() != nullptr) {
+    node_curr = node_curr->left();
   }
   return node_curr;
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::rotate_left(node* node_curr) {
-  node* right_child = node_curr->right_;
-  node_curr->right_ = right_child->left_;
-  if (node_curr->right_) {
-    node_curr->right_->parent_ = node_curr;
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::rotate_left(
+    node* node_curr) {
+  node* right_child = node_curr->right();
+  node_curr->right() = right_child->left();
+  if (node_curr->right()) {
+    node_curr->right()->set_parent(node_curr);
   }
-  right_child->parent_ = node_curr->parent_;
-  if (!node_curr->parent_) {
+  right_child->set_parent(node_curr->parent());
+  if (!node_curr->parent()) {
     root_ = right_child;
-  } else if (node_curr == node_curr->parent_->left_) {
-    node_curr->parent_->left_ = right_child;
+  } else if (node_curr == node_curr->parent()->left()) {
+    node_curr->parent()->left() = right_child;
   } else {
-    node_curr->parent_->right_ = right_child;
+    node_curr->parent()->right() = right_child;
   }
-  right_child->left_ = node_curr;
-  node_curr->parent_ = right_child;
+  right_child->left() = node_curr;
+  node_curr->set_parent(right_child);
+  augment::update(node_curr);
+  augment::update(right_child);
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::rotate_right(node* node_curr) {
-  node* left_child = node_curr->left_;
-  node_curr->left_ = left_child->right_;
-  if (node_curr->left_ != nullptr) {
-    node_curr->left_->parent_ = node_curr;
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::rotate_right(
+    node* node_curr) {
+  node* left_child = node_curr->left();
+  node_curr->left() = left_child->right();
+  if (node_curr->left() != nullptr) {
+    node_curr->left()->set_parent(node_curr);
   }
-  left_child->parent_ = node_curr->parent_;
-  if (node_curr->parent_ == nullptr) {
+  left_child->set_parent(node_curr->parent());
+  if (node_curr->parent() == nullptr) {
     root_ = left_child;
-  } else if (node_curr == node_curr->parent_->left_) {
-    node_curr->parent_->left_ = left_child;
+  } else if (node_curr == node_curr->parent()->left()) {
+    node_curr->parent()->left() = left_child;
   } else {
-    node_curr->parent_->right_ = left_child;
-  }
-  left_child->right_ = node_curr;
-  node_curr->parent_ = left_child;
-}
-
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::fix_violation(node* node_curr) {
-  while (node_curr != root_ && node_curr->parent_->color_ == red) {
-    node* parent = node_curr->parent_;
-    node* grandparent = parent->parent_;
-    if (parent == grandparent->left_) {
-      node* uncle = grandparent->right_;
-      if (uncle != nullptr && uncle->color_ == red) {
-        grandparent->color_ = red;
-        parent->color_ = black;
-        uncle->color_ = black;
+    node_curr->parent()->right() = left_child;
+  }
+  left_child->right() = node_curr;
+  node_curr->set_parent(left_child);
+  augment::update(node_curr);
+  augment::update(left_child);
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+bool s21::rb_tree<data_type, compare, allocator, key_of,
+                  augment>::fix_violation(node* node_curr) {
+  while (node_curr != root_ && node_curr->color() == red &&
+         node_curr->parent()->color() == red) {
+    node* parent = node_curr->parent();
+    node* grandparent = parent->parent();
+    if (parent == grandparent->left()) {
+      node* uncle = grandparent->right();
+      if (uncle != nullptr && uncle->color() == red) {
+        grandparent->set_color(red);
+        parent->set_color(black);
+        uncle->set_color(black);
         node_curr = grandparent;
       } else {
-        if (node_curr == parent->right_) {
+        if (node_curr == parent->right()) {
           rotate_left(parent);
           node_curr = parent;
-          parent = node_curr->parent_;
+          parent = node_curr->parent();
         }
         rotate_right(grandparent);
-        std::swap(parent->color_, grandparent->color_);
+        parent->set_color(black);
+        grandparent->set_color(red);
         node_curr = parent;
       }
     } else {
-      node* uncle = grandparent->left_;
-      if (uncle != nullptr && uncle->color_ == red) {
-        grandparent->color_ = red;
-        parent->color_ = black;
-        uncle->color_ = black;
+      node* uncle = grandparent->left();
+      if (uncle != nullptr && uncle->color() == red) {
+        grandparent->set_color(red);
+        parent->set_color(black);
+        uncle->set_color(black);
         node_curr = grandparent;
       } else {
-        if (node_curr == parent->left_) {
+        if (node_curr == parent->left()) {
           rotate_right(parent);
           node_curr = parent;
-          parent = node_curr->parent_;
+          parent = node_curr->parent();
         }
         rotate_left(grandparent);
-        std::swap(parent->color_, grandparent->color_);
+        parent->set_color(black);
+        grandparent->set_color(red);
         node_curr = parent;
       }
     }
   }
 
-  root_->color_ = black;
+  // красный корень перекрашивается, и чёрная высота дерева растёт на 1
+  bool grown = root_->color() == red;
+  root_->set_color(black);
+  return grown;
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::transplant(
+    node* old_node, node* new_node) {
+  if (!old_node->parent()) {
+    root_ = new_node;
+  } else if (old_node == old_node->parent()->left()) {
+    old_node->parent()->left() = new_node;
+  } else {
+    old_node->parent()->right() = new_node;
+  }
+  if (new_node) {
+    new_node->set_parent(old_node->parent());
+  }
 }
 
-template <typename data_type, typename compare>
-void s21::rb_tree<data_type, compare>::delete_fix(node* node_curr) {
-  while (node_curr != root_ && node_curr->color_ == black) {
-    if (node_curr == node_curr->parent_->left_) {
-      node* sibling = node_curr->parent_->right_;
-      if (sibling->color_ == red) {
-        sibling->color_ = black;
-        node_curr->parent_->color_ = red;
-        rotate_left(node_curr->parent_);
-        sibling = node_curr->parent_->right_;
+template <typename data_type, typename compare, typename allocator,
+          typename key_of, typename augment>
+void s21::rb_tree<data_type, compare, allocator, key_of, augment>::delete_fix(
+    node* node_curr, node* parent) {
+  while (node_curr != root_ && is_black(node_curr)) {
+    if (node_curr == parent->left()) {
+      node* sibling = parent->right();
+      if (sibling->color() == red) {
+        sibling->set_color(black);
+        parent->set_color(red);
+        rotate_left(parent);
+        sibling = parent->right();
       }
-      if (sibling->left_->color_ == black && sibling->right_->color_ == black) {
-        sibling->color_ = red;
-        node_curr = node_curr->parent_;
+      if (is_black(sibling->left()) && is_black(sibling->right())) {
+        sibling->set_color(red);
+        node_curr = parent;
+        parent = node_curr->parent();
       } else {
-        if (sibling->right_->color_ == black) {
-          sibling->left_->color_ = black;
-          sibling->color_ = red;
+        if (is_black(sibling->right())) {
+          sibling->left()->set_color(black);
+          sibling->set_color(red);
           rotate_right(sibling);
-          sibling = node_curr->parent_->right_;
+          sibling = parent->right();
         }
-        sibling->color_ = node_curr->parent_->color_;
-        node_curr->parent_->color_ = black;
-        sibling->right_->color_ = black;
-        rotate_left(node_curr->parent_);
+        sibling->set_color(parent->color());
+        parent->set_color(black);
+        sibling->right()->set_color(black);
+        rotate_left(parent);
         node_curr = root_;
       }
     } else {
-      node* sibling = node_curr->parent_->left_;
-      if (sibling->color_ == red) {
-        sibling->color_ = black;
-        node_curr->parent_->color_ = red;
-        rotate_right(node_curr->parent_);
-        sibling = node_curr->parent_->left_;
+      node* sibling = parent->left();
+      if (sibling->color() == red) {
+        sibling->set_color(black);
+        parent->set_color(red);
+        rotate_right(parent);
+        sibling = parent->left();
       }
-      if (sibling->left_->color_ == black && sibling->right_->color_ == black) {
-        sibling->color_ = red;
-        node_curr = node_curr->parent_;
+      if (is_black(sibling->left()) && is_black(sibling->right())) {
+        sibling->set_color(red);
+        node_curr = parent;
+        parent = node_curr->parent();
       } else {
-        if (sibling->left_->color_ == black) {
-          sibling->right_->color_ = black;
-          sibling->color_ = red;
+        if (is_black(sibling->left())) {
+          sibling->right()->set_color(black);
+          sibling->set_color(red);
           rotate_left(sibling);
-          sibling = node_curr->parent_->left_;
+          sibling = parent->left();
         }
-        sibling->color_ = node_curr->parent_->color_;
-        node_curr->parent_->color_ = black;
-        sibling->left_->color_ = black;
-        rotate_right(node_curr->parent_);
+        sibling->set_color(parent->color());
+        parent->set_color(black);
+        sibling->left()->set_color(black);
+        rotate_right(parent);
         node_curr = root_;
       }
     }
   }
-  node_curr->color_ = black;
+  if (node_curr) node_curr->set_color(black);
 }
 
 #endif
\ No newline at end of file
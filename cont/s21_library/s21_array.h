@@ -3,7 +3,9 @@
 
 #include <stddef.h>
 
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 namespace s21 {
 template <typename T, size_t _size>
@@ -78,6 +80,7 @@ class array {
 template <typename T, size_t _size>
 s21::array<T, _size>::array() {
   data_ = allocator_.allocate(size_);
+  std::uninitialized_value_construct_n(data_, size_);
 }
 
 template <typename T, size_t _size>
@@ -86,6 +89,7 @@ s21::array<T, _size>::array(std::ptrdiff_t n) : size_(n) {
     throw std::length_error("length_error");
   }
   data_ = allocator_.allocate(n);
+  std::uninitialized_value_construct_n(data_, n);
 }
 
 template <typename T, size_t _size>
@@ -146,7 +150,7 @@ s21::array<T, _size>& s21::array<T, _size>::operator=(array&& right) {
 template <typename T, size_t _size>
 typename s21::array<T, _size>::reference s21::array<T, _size>::at(
     size_type pos) {
-  if (pos >= size_ || pos < 0) throw std::out_of_range("out_of_range");
+  if (pos >= size_) throw std::out_of_range("out_of_range");
   return data_[pos];
 }
 
@@ -0,0 +1,152 @@
+#ifndef S21_CONCURRENT_MAP
+#define S21_CONCURRENT_MAP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+#include "s21_map.h"
+
+namespace s21 {
+
+// Потокобезопасный словарь: ключи распределяются по хешу между шардами,
+// каждый шард — отдельный s21::map под своим shared_mutex. Читатели одного
+// шарда не блокируют друг друга, писатели разных шардов не пересекаются.
+// Ссылки и итераторы наружу не отдаются: find возвращает копию значения,
+// а доступ к содержимому шарда возможен только внутри for_each_shard.
+template <typename Key, typename T, typename compare = std::less<Key>,
+          typename hash = std::hash<Key>>
+class concurrent_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using shard_map = map<Key, T, compare>;
+
+  // число шардов округляется вверх до степени двойки
+  explicit concurrent_map(size_t shard_count = 64);
+  concurrent_map(const concurrent_map&) = delete;
+  concurrent_map& operator=(const concurrent_map&) = delete;
+  ~concurrent_map() = default;
+
+  std::optional<T> find(const Key& key) const;
+  bool contains(const Key& key) const;
+  // возвращает true, если ключ был вставлен, и false, если значение
+  // заменено
+  template <typename M>
+  bool insert_or_assign(const Key& key, M&& obj);
+  bool erase(const Key& key);
+  void clear();
+
+  // размер на один момент времени: все шарды захватываются на чтение в
+  // фиксированном порядке, поэтому конкурирующие записи не попадают в
+  // сумму наполовину
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+  size_t shard_count() const noexcept { return shard_mask_ + 1; }
+
+  // fn(const shard_map&) вызывается для каждого шарда под его
+  // разделяемой блокировкой; шарды обходятся по очереди
+  template <typename function>
+  void for_each_shard(function&& fn) const;
+
+ private:
+  // шард занимает целые строки кэша, чтобы соседние блокировки не
+  // делили одну строку
+  struct alignas(64) shard {
+    mutable std::shared_mutex mutex_;
+    shard_map map_;
+  };
+
+  std::unique_ptr<shard[]> shards_;
+  size_t shard_mask_;
+  hash hash_;
+
+  shard& shard_of(const Key& key) const {
+    // std::hash для целых тождественен: без перемешивания ключи, кратные
+    // числу шардов, попали бы в один шард
+    uint64_t mixed =
+        static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return shards_[(mixed >> 32) & shard_mask_];
+  }
+};
+}  // namespace s21
+
+template <typename Key, typename T, typename compare, typename hash>
+s21::concurrent_map<Key, T, compare, hash>::concurrent_map(
+    size_t shard_count) {
+  size_t count = 1;
+  while (count < shard_count) count *= 2;
+  shards_.reset(new shard[count]);
+  shard_mask_ = count - 1;
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+std::optional<T> s21::concurrent_map<Key, T, compare, hash>::find(
+    const Key& key) const {
+  shard& part = shard_of(key);
+  std::shared_lock<std::shared_mutex> lock(part.mutex_);
+  auto it = part.map_.find(key);
+  if (it == part.map_.end()) return std::nullopt;
+  return it->second;
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+bool s21::concurrent_map<Key, T, compare, hash>::contains(
+    const Key& key) const {
+  shard& part = shard_of(key);
+  std::shared_lock<std::shared_mutex> lock(part.mutex_);
+  return part.map_.contains(key);
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+template <typename M>
+bool s21::concurrent_map<Key, T, compare, hash>::insert_or_assign(
+    const Key& key, M&& obj) {
+  shard& part = shard_of(key);
+  std::unique_lock<std::shared_mutex> lock(part.mutex_);
+  return part.map_.insert_or_assign(key, std::forward<M>(obj)).second;
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+bool s21::concurrent_map<Key, T, compare, hash>::erase(const Key& key) {
+  shard& part = shard_of(key);
+  std::unique_lock<std::shared_mutex> lock(part.mutex_);
+  auto it = part.map_.find(key);
+  if (it == part.map_.end()) return false;
+  part.map_.erase(it);
+  return true;
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+void s21::concurrent_map<Key, T, compare, hash>::clear() {
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    std::unique_lock<std::shared_mutex> lock(shards_[i].mutex_);
+    shards_[i].map_.clear();
+  }
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+size_t s21::concurrent_map<Key, T, compare, hash>::size() const {
+  for (size_t i = 0; i <= shard_mask_; ++i) shards_[i].mutex_.lock_shared();
+  size_t total = 0;
+  for (size_t i = 0; i <= shard_mask_; ++i) total += shards_[i].map_.size();
+  for (size_t i = 0; i <= shard_mask_; ++i) shards_[i].mutex_.unlock_shared();
+  return total;
+}
+
+template <typename Key, typename T, typename compare, typename hash>
+template <typename function>
+void s21::concurrent_map<Key, T, compare, hash>::for_each_shard(
+    function&& fn) const {
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    std::shared_lock<std::shared_mutex> lock(shards_[i].mutex_);
+    fn(static_cast<const shard_map&>(shards_[i].map_));
+  }
+}
+
+#endif
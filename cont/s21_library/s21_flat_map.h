@@ -0,0 +1,423 @@
+#ifndef S21_FLAT_MAP
+#define S21_FLAT_MAP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_vector.h"
+
+namespace s21 {
+
+// Отсортированная таблица на двух s21::vector: ключи лежат отдельно от
+// значений, поэтому двоичный поиск читает только массив ключей. Итератор
+// разыменовывается в пару ссылок {ключ, значение}. Как и у flat_set, любая
+// вставка или удаление делает итераторы недействительными.
+template <typename Key, typename T, typename compare = std::less<Key>>
+class flat_map {
+  template <typename owner, typename mapped>
+  class basic_iterator;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using iterator = basic_iterator<flat_map, T>;
+  using const_iterator = basic_iterator<const flat_map, const T>;
+
+  flat_map() = default;
+  flat_map(std::initializer_list<value_type> const& items) {
+    insert(items.begin(), items.end());
+  }
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  flat_map(input_iterator first, input_iterator last) {
+    insert(first, last);
+  }
+  flat_map(const flat_map& other) = default;
+  flat_map(flat_map&& other) = default;
+  ~flat_map() = default;
+  flat_map& operator=(const flat_map& other) = default;
+  flat_map& operator=(flat_map&& other) = default;
+
+  T& at(const Key& key);
+  const T& at(const Key& key) const;
+  T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+  iterator begin() noexcept { return iterator(this, 0); }
+  iterator end() noexcept { return iterator(this, size()); }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator end() const noexcept { return cend(); }
+  const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cend() const noexcept {
+    return const_iterator(this, size());
+  }
+
+  bool empty() const noexcept { return keys_.empty(); }
+  size_t size() const noexcept { return keys_.size(); }
+  size_t max_size() const noexcept { return keys_.max_size(); }
+
+  iterator lower_bound(const Key& key) {
+    return iterator(this, lower_index(key));
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return const_iterator(this, lower_index(key));
+  }
+  iterator upper_bound(const Key& key) {
+    return iterator(this, upper_index(key));
+  }
+  const_iterator upper_bound(const Key& key) const {
+    return const_iterator(this, upper_index(key));
+  }
+  iterator find(const Key& key) { return iterator(this, find_index(key)); }
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, find_index(key));
+  }
+  bool contains(const Key& key) const { return find_index(key) != size(); }
+  // пакетный поиск: в out по порядку пишется find(key) для каждого ключа
+  // из [first, last); двоичные поиски нескольких ключей чередуются
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator find_batch(forward_iterator first, forward_iterator last,
+                             output_iterator out) {
+    lower_bound_batch(first, last, [&](const auto& key, size_t index) {
+      bool found = index < size() && !compare_(key, keys()[index]);
+      *out++ = iterator(this, found ? index : size());
+    });
+    return out;
+  }
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator find_batch(forward_iterator first, forward_iterator last,
+                             output_iterator out) const {
+    lower_bound_batch(first, last, [&](const auto& key, size_t index) {
+      bool found = index < size() && !compare_(key, keys()[index]);
+      *out++ = const_iterator(this, found ? index : size());
+    });
+    return out;
+  }
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator contains_batch(forward_iterator first, forward_iterator last,
+                                 output_iterator out) const {
+    lower_bound_batch(first, last, [&](const auto& key, size_t index) {
+      *out++ = index < size() && !compare_(key, keys()[index]);
+    });
+    return out;
+  }
+
+  void clear() {
+    keys_.clear();
+    values_.clear();
+  }
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return try_emplace(key, obj);
+  }
+  template <typename input_iterator>
+  void insert(input_iterator first, input_iterator last);
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+  template <typename key_arg, typename... Args>
+  std::pair<iterator, bool> try_emplace(key_arg&& key, Args&&... args);
+  iterator erase(iterator pos);
+  size_t erase(const Key& key);
+  void swap(flat_map& other) noexcept {
+    keys_.swap(other.keys_);
+    values_.swap(other.values_);
+    std::swap(compare_, other.compare_);
+  }
+
+  // пары дописываются в конец, хвост сортируется и один раз сливается с
+  // упорядоченной частью; из равных ключей остаётся первый
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+ private:
+  vector<Key> keys_;
+  vector<T> values_;
+  compare compare_;
+
+  Key* keys() const noexcept { return keys_.begin().get_ptr(); }
+  T* values() const noexcept { return values_.begin().get_ptr(); }
+  size_t lower_index(const Key& key) const {
+    return std::lower_bound(keys(), keys() + size(), key, compare_) - keys();
+  }
+  size_t upper_index(const Key& key) const {
+    return std::upper_bound(keys(), keys() + size(), key, compare_) - keys();
+  }
+  size_t find_index(const Key& key) const {
+    size_t index = lower_index(key);
+    return index < size() && !compare_(key, keys()[index]) ? index : size();
+  }
+  void append(value_type&& value) {
+    keys_.push_back(std::move(value.first));
+    values_.push_back(std::move(value.second));
+  }
+  void merge_tail(size_t sorted_size);
+  // emit(key, index) получает индекс lower_bound каждого ключа по порядку
+  template <typename forward_iterator, typename function>
+  void lower_bound_batch(forward_iterator first, forward_iterator last,
+                         function&& emit) const;
+  static void prefetch(const Key* address) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+  }
+};
+
+template <typename Key, typename T, typename compare>
+template <typename owner, typename mapped>
+class flat_map<Key, T, compare>::basic_iterator {
+  // operator-> возвращает пару ссылок через временный объект
+  struct arrow_proxy {
+    std::pair<const Key&, mapped&> pair_;
+    std::pair<const Key&, mapped&>* operator->() { return &pair_; }
+  };
+
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = std::pair<Key, T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::pair<const Key&, mapped&>;
+  using pointer = arrow_proxy;
+
+  basic_iterator() : map_(nullptr), index_(0) {}
+  basic_iterator(owner* map, size_t index) : map_(map), index_(index) {}
+  template <typename other_owner, typename other_mapped,
+            typename = std::enable_if_t<std::is_const_v<owner> &&
+                                        !std::is_const_v<other_owner>>>
+  basic_iterator(const basic_iterator<other_owner, other_mapped>& other)
+      : map_(other.map_), index_(other.index_) {}
+
+  reference operator*() const {
+    return {map_->keys()[index_], map_->values()[index_]};
+  }
+  pointer operator->() const { return pointer{**this}; }
+  basic_iterator& operator++() {
+    ++index_;
+    return *this;
+  }
+  basic_iterator operator++(int) {
+    basic_iterator copy = *this;
+    ++index_;
+    return copy;
+  }
+  basic_iterator& operator--() {
+    --index_;
+    return *this;
+  }
+  basic_iterator operator--(int) {
+    basic_iterator copy = *this;
+    --index_;
+    return copy;
+  }
+  bool operator==(const basic_iterator& other) const {
+    return index_ == other.index_;
+  }
+  bool operator!=(const basic_iterator& other) const {
+    return index_ != other.index_;
+  }
+
+ private:
+  friend class flat_map;
+  template <typename, typename>
+  friend class basic_iterator;
+  owner* map_;
+  size_t index_;
+};
+}  // namespace s21
+
+template <typename Key, typename T, typename compare>
+T& s21::flat_map<Key, T, compare>::at(const Key& key) {
+  size_t index = find_index(key);
+  if (index == size()) {
+    throw std::out_of_range("flat_map::at");
+  }
+  return values()[index];
+}
+
+template <typename Key, typename T, typename compare>
+const T& s21::flat_map<Key, T, compare>::at(const Key& key) const {
+  size_t index = find_index(key);
+  if (index == size()) {
+    throw std::out_of_range("flat_map::at");
+  }
+  return values()[index];
+}
+
+template <typename Key, typename T, typename compare>
+template <typename input_iterator>
+void s21::flat_map<Key, T, compare>::insert(input_iterator first,
+                                            input_iterator last) {
+  size_t sorted_size = size();
+  for (; first != last; ++first) {
+    append(value_type(*first));
+  }
+  merge_tail(sorted_size);
+}
+
+template <typename Key, typename T, typename compare>
+template <typename M>
+std::pair<typename s21::flat_map<Key, T, compare>::iterator, bool>
+s21::flat_map<Key, T, compare>::insert_or_assign(const Key& key, M&& obj) {
+  auto result = try_emplace(key, std::forward<M>(obj));
+  if (!result.second) {
+    values()[result.first.index_] = std::forward<M>(obj);
+  }
+  return result;
+}
+
+template <typename Key, typename T, typename compare>
+template <typename key_arg, typename... Args>
+std::pair<typename s21::flat_map<Key, T, compare>::iterator, bool>
+s21::flat_map<Key, T, compare>::try_emplace(key_arg&& key, Args&&... args) {
+  // значение строится только если ключа ещё нет
+  size_t index = lower_index(key);
+  if (index < size() && !compare_(key, keys()[index])) {
+    return {iterator(this, index), false};
+  }
+  keys_.push_back(Key(std::forward<key_arg>(key)));
+  values_.push_back(T(std::forward<Args>(args)...));
+  std::rotate(keys() + index, keys() + size() - 1, keys() + size());
+  std::rotate(values() + index, values() + size() - 1, values() + size());
+  return {iterator(this, index), true};
+}
+
+template <typename Key, typename T, typename compare>
+typename s21::flat_map<Key, T, compare>::iterator
+s21::flat_map<Key, T, compare>::erase(iterator pos) {
+  size_t index = pos.index_;
+  std::move(keys() + index + 1, keys() + size(), keys() + index);
+  std::move(values() + index + 1, values() + size(), values() + index);
+  keys_.pop_back();
+  values_.pop_back();
+  return iterator(this, index);
+}
+
+template <typename Key, typename T, typename compare>
+size_t s21::flat_map<Key, T, compare>::erase(const Key& key) {
+  size_t index = find_index(key);
+  if (index == size()) return 0;
+  erase(iterator(this, index));
+  return 1;
+}
+
+template <typename Key, typename T, typename compare>
+template <typename... Args>
+std::vector<std::pair<typename s21::flat_map<Key, T, compare>::iterator, bool>>
+s21::flat_map<Key, T, compare>::insert_many(Args&&... args) {
+  size_t sorted_size = size();
+  (append(value_type(std::forward<Args>(args))), ...);
+  // вставленной считается первая из пар с равными новыми ключами, если
+  // такого ключа не было раньше
+  std::vector<size_t> order(size() - sorted_size);
+  for (size_t i = 0; i < order.size(); ++i) order[i] = sorted_size + i;
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return compare_(keys()[a], keys()[b]);
+  });
+  std::vector<bool> inserted(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    const Key& key = keys()[order[i]];
+    bool repeated = i > 0 && !compare_(keys()[order[i - 1]], key);
+    inserted[order[i] - sorted_size] =
+        !repeated &&
+        !std::binary_search(keys(), keys() + sorted_size, key, compare_);
+  }
+  std::vector<Key> added(keys() + sorted_size, keys() + size());
+  merge_tail(sorted_size);
+  std::vector<std::pair<iterator, bool>> results;
+  results.reserve(added.size());
+  for (size_t i = 0; i < added.size(); ++i) {
+    results.emplace_back(find(added[i]), inserted[i]);
+  }
+  return results;
+}
+
+template <typename Key, typename T, typename compare>
+template <typename forward_iterator, typename function>
+void s21::flat_map<Key, T, compare>::lower_bound_batch(
+    forward_iterator first, forward_iterator last, function&& emit) const {
+  constexpr size_t batch_lanes = 16;
+  forward_iterator targets[batch_lanes];
+  const Key* base[batch_lanes];
+  while (first != last) {
+    size_t lanes = 0;
+    for (; lanes < batch_lanes && first != last; ++lanes, ++first) {
+      targets[lanes] = first;
+      base[lanes] = keys();
+    }
+    // длина отрезка зависит только от размера массива, поэтому поиски
+    // идут в ногу; на каждом шаге оба возможных следующих сравнения
+    // запрашиваются из памяти заранее
+    size_t length = size();
+    while (length > 1) {
+      size_t half = length / 2;
+      size_t next_half = (length - half) / 2;
+      for (size_t lane = 0; lane < lanes; ++lane) {
+        const Key* probe = base[lane];
+        prefetch(probe + next_half);
+        prefetch(probe + half + next_half);
+        base[lane] =
+            compare_(probe[half], *targets[lane]) ? probe + half : probe;
+      }
+      length -= half;
+    }
+    for (size_t lane = 0; lane < lanes; ++lane) {
+      const Key* probe = base[lane];
+      size_t index = probe - keys();
+      if (length == 1 && compare_(*probe, *targets[lane])) ++index;
+      emit(*targets[lane], index);
+    }
+  }
+}
+
+template <typename Key, typename T, typename compare>
+void s21::flat_map<Key, T, compare>::merge_tail(size_t sorted_size) {
+  // хвост упорядочивается перестановкой индексов, затем обе части
+  // сливаются в новые массивы за один проход
+  std::vector<size_t> order(size() - sorted_size);
+  for (size_t i = 0; i < order.size(); ++i) order[i] = sorted_size + i;
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return compare_(keys()[a], keys()[b]);
+  });
+  vector<Key> keys_merged;
+  vector<T> values_merged;
+  keys_merged.reserve(size());
+  values_merged.reserve(size());
+  auto take = [&](size_t index) {
+    const Key& key = keys()[index];
+    if (!keys_merged.empty() && !compare_(keys_merged.back(), key)) {
+      return;
+    }
+    keys_merged.push_back(std::move(keys()[index]));
+    values_merged.push_back(std::move(values()[index]));
+  };
+  size_t left = 0;
+  size_t right = 0;
+  while (left < sorted_size || right < order.size()) {
+    // при равных ключах первым идёт уже существовавший
+    if (right == order.size() ||
+        (left < sorted_size &&
+         !compare_(keys()[order[right]], keys()[left]))) {
+      take(left++);
+    } else {
+      take(order[right++]);
+    }
+  }
+  keys_.swap(keys_merged);
+  values_.swap(values_merged);
+}
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef S21_FLAT_SET
+#define S21_FLAT_SET
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "s21_vector.h"
+
+namespace s21 {
+
+// Отсортированный массив уникальных ключей в s21::vector. Поиск — двоичный
+// по непрерывной памяти, вставка и удаление одного ключа сдвигают хвост,
+// поэтому контейнер рассчитан на таблицы, которые заполняются один раз и
+// потом только читаются. Любая вставка или удаление делает итераторы
+// недействительными.
+template <typename Key, typename compare = std::less<Key>>
+class flat_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using iterator = const Key*;
+  using const_iterator = const Key*;
+
+  flat_set() = default;
+  flat_set(std::initializer_list<Key> const& items) {
+    insert(items.begin(), items.end());
+  }
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  flat_set(input_iterator first, input_iterator last) {
+    insert(first, last);
+  }
+  flat_set(const flat_set& other) = default;
+  flat_set(flat_set&& other) = default;
+  ~flat_set() = default;
+  flat_set& operator=(const flat_set& other) = default;
+  flat_set& operator=(flat_set&& other) = default;
+
+  iterator begin() const noexcept { return data(); }
+  iterator end() const noexcept { return data() + keys_.size(); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  bool empty() const noexcept { return keys_.empty(); }
+  size_t size() const noexcept { return keys_.size(); }
+  size_t max_size() const noexcept { return keys_.max_size(); }
+
+  iterator lower_bound(const Key& key) const {
+    return std::lower_bound(begin(), end(), key, compare_);
+  }
+  iterator upper_bound(const Key& key) const {
+    return std::upper_bound(begin(), end(), key, compare_);
+  }
+  iterator find(const Key& key) const {
+    iterator pos = lower_bound(key);
+    return pos != end() && !compare_(key, *pos) ? pos : end();
+  }
+  bool contains(const Key& key) const { return find(key) != end(); }
+  // пакетный поиск: в out по порядку пишется find(key) для каждого ключа
+  // из [first, last); двоичные поиски нескольких ключей чередуются
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator find_batch(forward_iterator first, forward_iterator last,
+                             output_iterator out) const {
+    lower_bound_batch(first, last, [&](const auto& key, size_t index) {
+      bool found = index < size() && !compare_(key, data()[index]);
+      *out++ = found ? begin() + index : end();
+    });
+    return out;
+  }
+  template <typename forward_iterator, typename output_iterator>
+  output_iterator contains_batch(forward_iterator first, forward_iterator last,
+                                 output_iterator out) const {
+    lower_bound_batch(first, last, [&](const auto& key, size_t index) {
+      *out++ = index < size() && !compare_(key, data()[index]);
+    });
+    return out;
+  }
+
+  void clear() { keys_.clear(); }
+  std::pair<iterator, bool> insert(const Key& key) { return emplace(key); }
+  std::pair<iterator, bool> insert(Key&& key) {
+    return emplace(std::move(key));
+  }
+  template <typename input_iterator>
+  void insert(input_iterator first, input_iterator last);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+  iterator erase(iterator pos);
+  size_t erase(const Key& key);
+  void swap(flat_set& other) noexcept {
+    keys_.swap(other.keys_);
+    std::swap(compare_, other.compare_);
+  }
+
+  // все ключи дописываются в конец, затем хвост сортируется и один раз
+  // сливается с уже упорядоченной частью
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+ private:
+  vector<Key> keys_;
+  compare compare_;
+
+  Key* data() const noexcept { return keys_.begin().get_ptr(); }
+  void merge_tail(size_t sorted_size);
+  // emit(key, index) получает индекс lower_bound каждого ключа по порядку
+  template <typename forward_iterator, typename function>
+  void lower_bound_batch(forward_iterator first, forward_iterator last,
+                         function&& emit) const;
+  static void prefetch(const Key* address) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+  }
+};
+}  // namespace s21
+
+template <typename Key, typename compare>
+template <typename input_iterator>
+void s21::flat_set<Key, compare>::insert(input_iterator first,
+                                         input_iterator last) {
+  size_t sorted_size = keys_.size();
+  for (; first != last; ++first) {
+    keys_.push_back(Key(*first));
+  }
+  merge_tail(sorted_size);
+}
+
+template <typename Key, typename compare>
+template <typename... Args>
+std::pair<typename s21::flat_set<Key, compare>::iterator, bool>
+s21::flat_set<Key, compare>::emplace(Args&&... args) {
+  Key key(std::forward<Args>(args)...);
+  size_t index = lower_bound(key) - begin();
+  if (index < keys_.size() && !compare_(key, data()[index])) {
+    return {begin() + index, false};
+  }
+  keys_.push_back(std::move(key));
+  std::rotate(data() + index, data() + keys_.size() - 1,
+              data() + keys_.size());
+  return {begin() + index, true};
+}
+
+template <typename Key, typename compare>
+typename s21::flat_set<Key, compare>::iterator
+s21::flat_set<Key, compare>::erase(iterator pos) {
+  size_t index = pos - begin();
+  std::move(data() + index + 1, data() + keys_.size(), data() + index);
+  keys_.pop_back();
+  return begin() + index;
+}
+
+template <typename Key, typename compare>
+size_t s21::flat_set<Key, compare>::erase(const Key& key) {
+  iterator pos = find(key);
+  if (pos == end()) return 0;
+  erase(pos);
+  return 1;
+}
+
+template <typename Key, typename compare>
+template <typename... Args>
+std::vector<std::pair<typename s21::flat_set<Key, compare>::iterator, bool>>
+s21::flat_set<Key, compare>::insert_many(Args&&... args) {
+  size_t sorted_size = keys_.size();
+  (keys_.push_back(Key(std::forward<Args>(args))), ...);
+  // вставленным считается первый из равных новых ключей, если такого ключа
+  // не было раньше
+  std::vector<size_t> order(keys_.size() - sorted_size);
+  for (size_t i = 0; i < order.size(); ++i) order[i] = sorted_size + i;
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return compare_(data()[a], data()[b]);
+  });
+  std::vector<bool> inserted(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    const Key& key = data()[order[i]];
+    bool repeated = i > 0 && !compare_(data()[order[i - 1]], key);
+    inserted[order[i] - sorted_size] =
+        !repeated &&
+        !std::binary_search(data(), data() + sorted_size, key, compare_);
+  }
+  std::vector<Key> keys;
+  keys.reserve(order.size());
+  for (size_t index = sorted_size; index < keys_.size(); ++index) {
+    keys.push_back(data()[index]);
+  }
+  merge_tail(sorted_size);
+  std::vector<std::pair<iterator, bool>> results;
+  results.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    results.emplace_back(find(keys[i]), inserted[i]);
+  }
+  return results;
+}
+
+template <typename Key, typename compare>
+template <typename forward_iterator, typename function>
+void s21::flat_set<Key, compare>::lower_bound_batch(
+    forward_iterator first, forward_iterator last, function&& emit) const {
+  constexpr size_t batch_lanes = 16;
+  forward_iterator targets[batch_lanes];
+  const Key* base[batch_lanes];
+  while (first != last) {
+    size_t lanes = 0;
+    for (; lanes < batch_lanes && first != last; ++lanes, ++first) {
+      targets[lanes] = first;
+      base[lanes] = data();
+    }
+    // длина отрезка зависит только от размера массива, поэтому поиски
+    // идут в ногу; на каждом шаге оба возможных следующих сравнения
+    // запрашиваются из памяти заранее
+    size_t length = size();
+    while (length > 1) {
+      size_t half = length / 2;
+      size_t next_half = (length - half) / 2;
+      for (size_t lane = 0; lane < lanes; ++lane) {
+        const Key* probe = base[lane];
+        prefetch(probe + next_half);
+        prefetch(probe + half + next_half);
+        base[lane] =
+            compare_(probe[half], *targets[lane]) ? probe + half : probe;
+      }
+      length -= half;
+    }
+    for (size_t lane = 0; lane < lanes; ++lane) {
+      const Key* probe = base[lane];
+      size_t index = probe - data();
+      if (length == 1 && compare_(*probe, *targets[lane])) ++index;
+      emit(*targets[lane], index);
+    }
+  }
+}
+
+template <typename Key, typename compare>
+void s21::flat_set<Key, compare>::merge_tail(size_t sorted_size) {
+  Key* first = data();
+  Key* middle = first + sorted_size;
+  Key* last = first + keys_.size();
+  std::stable_sort(middle, last, compare_);
+  std::inplace_merge(first, middle, last, compare_);
+  // при равных ключах inplace_merge ставит старый раньше нового, поэтому
+  // unique оставляет уже существовавший ключ
+  Key* unique_end =
+      std::unique(first, last, [this](const Key& left, const Key& right) {
+        return !compare_(left, right);
+      });
+  while (data() + keys_.size() != unique_end) keys_.pop_back();
+}
+
+#endif
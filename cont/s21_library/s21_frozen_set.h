@@ -0,0 +1,300 @@
+#ifndef S21_FROZEN_SET
+#define S21_FROZEN_SET
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Неизменяемое множество в порядке Эйтцингера: ключи лежат в одном
+// массиве как полное двоичное дерево в ширину, потомки вершины k — 2k и
+// 2k + 1 (нумерация с единицы). Верхние уровни всех спусков делят одни и
+// те же строки кэша, а следующие уровни заранее подтягиваются prefetch.
+// Спуск не ветвится по результату сравнения: оно лишь добавляется к
+// индексу. Получается из set::freeze() или из любой последовательности.
+template <typename Key, typename compare = std::less<Key>>
+class frozen_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  class const_iterator;
+  using iterator = const_iterator;
+  using reverse_iterator = std::reverse_iterator<const_iterator>;
+  using const_reverse_iterator = reverse_iterator;
+
+  frozen_set() = default;
+  frozen_set(std::initializer_list<Key> const& items)
+      : frozen_set(items.begin(), items.end()) {}
+  // вход сортируется и избавляется от повторов во временном векторе
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  frozen_set(input_iterator first, input_iterator last,
+             const compare& comp = compare());
+  frozen_set(const frozen_set& other);
+  frozen_set(frozen_set&& other) noexcept { swap(other); }
+  ~frozen_set() { release(); }
+  frozen_set& operator=(frozen_set other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  // count ключей строго по возрастанию, без повторов; так set::freeze
+  // раскладывает дерево за один обход без промежуточной копии
+  template <typename input_iterator>
+  static frozen_set from_sorted(input_iterator first, size_t count,
+                                const compare& comp = compare());
+
+  const_iterator begin() const noexcept {
+    return const_iterator(this, size_ ? leftmost(1) : 0);
+  }
+  const_iterator end() const noexcept { return const_iterator(this, 0); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+  reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+  reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_t size() const noexcept { return size_; }
+
+  const_iterator lower_bound(const Key& key) const {
+    return const_iterator(this, lower_index(key));
+  }
+  const_iterator upper_bound(const Key& key) const;
+  const_iterator find(const Key& key) const {
+    size_t index = lower_index(key);
+    bool found = index != 0 && !compare_(key, keys_[index]);
+    return const_iterator(this, found ? index : 0);
+  }
+  bool contains(const Key& key) const { return find(key) != end(); }
+
+  void swap(frozen_set& other) noexcept {
+    std::swap(keys_, other.keys_);
+    std::swap(size_, other.size_);
+    std::swap(compare_, other.compare_);
+  }
+
+ private:
+  // массив выровнен по строке кэша, чтобы блок из 16 правнуков вершины
+  // занимал как можно меньше строк
+  static constexpr size_t block_alignment =
+      alignof(Key) > 64 ? alignof(Key) : 64;
+  // prefetch смотрит на 4 уровня вперёд: потомки вершины k на этой
+  // глубине — 16 подряд идущих ключей начиная с 16k
+  static constexpr size_t prefetch_levels = 4;
+
+  // вершина k хранится в keys_[k], keys_[0] не занят: так блок правнуков
+  // 16k..16k + 15 начинается с границы выравнивания
+  Key* keys_ = nullptr;
+  size_t size_ = 0;
+  compare compare_;
+
+  void allocate(size_t count);
+  void release() noexcept;
+  // раскладывает count отсортированных ключей по вершинам в порядке
+  // симметричного обхода
+  template <typename input_iterator>
+  void fill_sorted(input_iterator first, size_t count);
+  // индекс вершины первого ключа не меньше key, 0 если такого нет
+  size_t lower_index(const Key& key) const;
+
+  size_t leftmost(size_t index) const noexcept {
+    while (2 * index <= size_) index *= 2;
+    return index;
+  }
+  size_t rightmost(size_t index) const noexcept {
+    while (2 * index + 1 <= size_) index = 2 * index + 1;
+    return index;
+  }
+  size_t next_index(size_t index) const noexcept {
+    if (2 * index + 1 <= size_) return leftmost(2 * index + 1);
+    // подъём, пока вершина — правый потомок; родитель левого — следующий
+    index >>= trailing_ones(index) + 1;
+    return index;
+  }
+  size_t prev_index(size_t index) const noexcept {
+    if (index == 0) return rightmost(1);
+    if (2 * index <= size_) return rightmost(2 * index);
+    while ((index & 1) == 0) index >>= 1;
+    return index >> 1;
+  }
+  static size_t trailing_ones(size_t index) noexcept {
+#if defined(__GNUC__)
+    return __builtin_ctzll(~static_cast<unsigned long long>(index));
+#else
+    size_t ones = 0;
+    for (; index & 1; index >>= 1) ++ones;
+    return ones;
+#endif
+  }
+  static void prefetch(const Key* address) noexcept {
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+  }
+};
+
+// двунаправленный итератор по возрастанию: переход к соседней вершине
+// симметричного обхода, в среднем O(1)
+template <typename Key, typename compare>
+class frozen_set<Key, compare>::const_iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Key;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Key*;
+  using reference = const Key&;
+
+  const_iterator() = default;
+  const Key& operator*() const { return set_->keys_[index_]; }
+  const Key* operator->() const { return set_->keys_ + index_; }
+  const_iterator& operator++() {
+    index_ = set_->next_index(index_);
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator old = *this;
+    ++*this;
+    return old;
+  }
+  const_iterator& operator--() {
+    index_ = set_->prev_index(index_);
+    return *this;
+  }
+  const_iterator operator--(int) {
+    const_iterator old = *this;
+    --*this;
+    return old;
+  }
+  bool operator==(const const_iterator& other) const {
+    return index_ == other.index_;
+  }
+  bool operator!=(const const_iterator& other) const {
+    return index_ != other.index_;
+  }
+
+ private:
+  friend class frozen_set;
+  const_iterator(const frozen_set* set, size_t index)
+      : set_(set), index_(index) {}
+
+  const frozen_set* set_ = nullptr;
+  size_t index_ = 0;  // 0 — end()
+};
+}  // namespace s21
+
+template <typename Key, typename compare>
+template <typename input_iterator, typename>
+s21::frozen_set<Key, compare>::frozen_set(input_iterator first,
+                                          input_iterator last,
+                                          const compare& comp)
+    : compare_(comp) {
+  std::vector<Key> sorted(first, last);
+  std::sort(sorted.begin(), sorted.end(), compare_);
+  auto equal = [this](const Key& a, const Key& b) {
+    return !compare_(a, b) && !compare_(b, a);
+  };
+  sorted.erase(std::unique(sorted.begin(), sorted.end(), equal), sorted.end());
+  fill_sorted(std::make_move_iterator(sorted.begin()), sorted.size());
+}
+
+template <typename Key, typename compare>
+s21::frozen_set<Key, compare>::frozen_set(const frozen_set& other)
+    : compare_(other.compare_) {
+  allocate(other.size_);
+  try {
+    std::uninitialized_copy_n(other.keys_ + 1, other.size_, keys_ + 1);
+  } catch (...) {
+    if (keys_) ::operator delete(keys_, std::align_val_t(block_alignment));
+    throw;
+  }
+  size_ = other.size_;
+}
+
+template <typename Key, typename compare>
+template <typename input_iterator>
+s21::frozen_set<Key, compare> s21::frozen_set<Key, compare>::from_sorted(
+    input_iterator first, size_t count, const compare& comp) {
+  frozen_set result;
+  result.compare_ = comp;
+  result.fill_sorted(first, count);
+  return result;
+}
+
+template <typename Key, typename compare>
+void s21::frozen_set<Key, compare>::allocate(size_t count) {
+  if (count == 0) return;
+  keys_ = static_cast<Key*>(::operator new(
+      (count + 1) * sizeof(Key), std::align_val_t(block_alignment)));
+}
+
+template <typename Key, typename compare>
+void s21::frozen_set<Key, compare>::release() noexcept {
+  if (!keys_) return;
+  std::destroy_n(keys_ + 1, size_);
+  ::operator delete(keys_, std::align_val_t(block_alignment));
+  keys_ = nullptr;
+  size_ = 0;
+}
+
+template <typename Key, typename compare>
+template <typename input_iterator>
+void s21::frozen_set<Key, compare>::fill_sorted(input_iterator first,
+                                                size_t count) {
+  release();
+  allocate(count);
+  // size_ нужен обходу заранее; при исключении уничтожаются только уже
+  // построенные ключи, а их вершины не образуют префикса массива
+  size_t built = 0;
+  size_ = count;
+  size_t index = count ? leftmost(1) : 0;
+  try {
+    for (; built < count; ++built, ++first) {
+      ::new (static_cast<void*>(keys_ + index)) Key(*first);
+      index = next_index(index);
+    }
+  } catch (...) {
+    for (index = count ? leftmost(1) : 0; built > 0; --built) {
+      std::destroy_at(keys_ + index);
+      index = next_index(index);
+    }
+    ::operator delete(keys_, std::align_val_t(block_alignment));
+    keys_ = nullptr;
+    size_ = 0;
+    throw;
+  }
+}
+
+template <typename Key, typename compare>
+size_t s21::frozen_set<Key, compare>::lower_index(const Key& key) const {
+  size_t index = 1;
+  while (index <= size_) {
+    prefetch(keys_ + std::min(index << prefetch_levels, size_));
+    // сравнение даёт 0 или 1: спуск влево или вправо без перехода
+    index = 2 * index + compare_(keys_[index], key);
+  }
+  // снимаются правые повороты после последнего левого: он и был ответом
+  return index >> (trailing_ones(index) + 1);
+}
+
+template <typename Key, typename compare>
+typename s21::frozen_set<Key, compare>::const_iterator
+s21::frozen_set<Key, compare>::upper_bound(const Key& key) const {
+  size_t index = 1;
+  while (index <= size_) {
+    prefetch(keys_ + std::min(index << prefetch_levels, size_));
+    index = 2 * index + !compare_(key, keys_[index]);
+  }
+  return const_iterator(this, index >> (trailing_ones(index) + 1));
+}
+
+#endif
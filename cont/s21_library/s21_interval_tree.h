@@ -0,0 +1,137 @@
+#ifndef S21_INTERVAL_TREE
+#define S21_INTERVAL_TREE
+
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+#include "red_black_tree/rb_tree.h"
+
+namespace s21 {
+
+// Интервалы [start, end) в rb_tree, упорядоченном по началу; каждый узел
+// хранит наибольший конец в своём поддереве (политика max_endpoint), и
+// дерево пересчитывает его при вставке, удалении и поворотах. Поиск
+// пересечений и протыкание точкой стоят O(min(n, (k + 1)·log n)), где
+// k — число найденных интервалов: max_end_ отсекает только поддеревья без
+// ответов, поэтому спуск может пройти весь путь от корня до каждого
+// найденного интервала. Интервалы с одинаковым началом допускаются.
+// Итераторы только константные: правка конца в обход дерева сломала бы
+// дополнение.
+template <typename Key, typename compare = std::less<Key>,
+          typename allocator = std::allocator<std::pair<Key, Key>>>
+class interval_tree
+    : protected rb_tree<std::pair<Key, Key>, compare, allocator, select_first,
+                        max_endpoint<compare>> {
+  using base = rb_tree<std::pair<Key, Key>, compare, allocator, select_first,
+                       max_endpoint<compare>>;
+  using node = typename base::node;
+
+ public:
+  using key_type = Key;
+  using value_type = std::pair<Key, Key>;
+  using iterator = typename base::const_iterator;
+  using const_iterator = typename base::const_iterator;
+
+  interval_tree() : base() {}
+  interval_tree(std::initializer_list<value_type> const& items) {
+    for (const value_type& item : items) insert(item);
+  }
+  interval_tree(const interval_tree& other) : base(other) {}
+  interval_tree(interval_tree&& other) noexcept : base(std::move(other)) {}
+  ~interval_tree() = default;
+  interval_tree& operator=(interval_tree&& other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  const_iterator begin() const { return base::cbegin(); }
+  const_iterator end() const { return base::cend(); }
+  const_iterator cbegin() const { return base::cbegin(); }
+  const_iterator cend() const { return base::cend(); }
+
+  bool empty() const noexcept { return base::empty(); }
+  size_t size() const noexcept { return base::size(); }
+  void clear() { base::clear(); }
+  using base::is_balanced;
+
+  iterator insert(const value_type& interval) {
+    return this->insert_value(false, interval).first;
+  }
+  iterator insert(const Key& start, const Key& end) {
+    return this->emplace_value(false, start, end).first;
+  }
+  void erase(const_iterator pos) { base::extract(pos); }
+  // удаляет один интервал с такими концами; false, если его нет
+  bool erase(const Key& start, const Key& end);
+  void swap(interval_tree& other) noexcept { base::swap(other); }
+
+  // fn(interval) для каждого интервала, пересекающего [lo, hi), по
+  // возрастанию начала
+  template <typename function>
+  void overlapping(const Key& lo, const Key& hi, function&& fn) const {
+    if (this->compare_(lo, hi)) visit_overlapping(this->root_, lo, hi, fn);
+  }
+  // fn(interval) для каждого интервала, содержащего point
+  template <typename function>
+  void stab(const Key& point, function&& fn) const {
+    visit_stabbing(this->root_, point, fn);
+  }
+  // наибольший конец среди всех интервалов; дерево не должно быть пустым
+  const Key& max_end() const { return this->root_->max_end_; }
+
+ private:
+  template <typename function>
+  void visit_overlapping(const node* node_curr, const Key& lo, const Key& hi,
+                         function& fn) const;
+  template <typename function>
+  void visit_stabbing(const node* node_curr, const Key& point,
+                      function& fn) const;
+  bool unique_keys() const noexcept override { return false; }
+};
+}  // namespace s21
+
+template <typename Key, typename compare, typename allocator>
+bool s21::interval_tree<Key, compare, allocator>::erase(const Key& start,
+                                                       const Key& end) {
+  auto range = base::equal_range(start);
+  for (const_iterator it = range.first; it != range.second; ++it) {
+    if (!this->compare_(it->second, end) && !this->compare_(end, it->second)) {
+      erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Key, typename compare, typename allocator>
+template <typename function>
+void s21::interval_tree<Key, compare, allocator>::visit_overlapping(
+    const node* node_curr, const Key& lo, const Key& hi, function& fn) const {
+  // интервал пересекает [lo, hi), если start < hi и lo < end. Поддерево,
+  // где все концы не больше lo, пропускается целиком; правее узла с
+  // началом не меньше hi пересечений тоже нет
+  while (node_curr && this->compare_(lo, node_curr->max_end_)) {
+    visit_overlapping(node_curr->left(), lo, hi, fn);
+    const value_type& interval = node_curr->data_;
+    if (!this->compare_(interval.first, hi)) return;
+    if (this->compare_(lo, interval.second)) fn(interval);
+    node_curr = node_curr->right();
+  }
+}
+
+template <typename Key, typename compare, typename allocator>
+template <typename function>
+void s21::interval_tree<Key, compare, allocator>::visit_stabbing(
+    const node* node_curr, const Key& point, function& fn) const {
+  // то же, что пересечение с [point, point]: start <= point < end
+  while (node_curr && this->compare_(point, node_curr->max_end_)) {
+    visit_stabbing(node_curr->left(), point, fn);
+    const value_type& interval = node_curr->data_;
+    if (this->compare_(point, interval.first)) return;
+    if (this->compare_(point, interval.second)) fn(interval);
+    node_curr = node_curr->right();
+  }
+}
+
+#endif
@@ -1,47 +1,77 @@
 #ifndef S21_MAP
 #define S21_MAP
 
+#include <tuple>
 #include <vector>
 
+#include "b_tree/b_tree.h"
+#include "persistent_tree/persistent_tree.h"
 #include "red_black_tree/rb_tree.h"
 
 namespace s21 {
-template <typename Key, typename T>
-struct pair_compare {
-  bool operator()(const std::pair<Key, T>& lhs,
-                  const std::pair<Key, T>& rhs) const {
-    return lhs.first < rhs.first;
-  }
-};
-
-template <typename Key, typename T, typename compare = pair_compare<Key, T>>
-class map : public rb_tree<std::pair<Key, T>, compare> {
-  using base = rb_tree<std::pair<Key, T>, compare>;
+template <typename Key, typename T, typename compare = std::less<Key>,
+          typename allocator = std::allocator<std::pair<Key, T>>,
+          typename augment = no_augment>
+class map : public rb_tree<std::pair<Key, T>, compare, allocator, select_first,
+                           augment> {
+  using base =
+      rb_tree<std::pair<Key, T>, compare, allocator, select_first, augment>;
 
  public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
   using iterator = typename base::iterator;
   using const_iterator = typename base::const_iterator;
+  using reverse_iterator = typename base::reverse_iterator;
+  using const_reverse_iterator = typename base::const_reverse_iterator;
+  using node_type = typename base::node_handle;
+  using insert_return_type = typename base::insert_return_type;
+  // у map с monoid_augment значения только читаются; меняются они через
+  // insert_or_assign и update, которые пересчитывают агрегаты
+  using mapped_reference =
+      std::conditional_t<base::read_only_values, const T&, T&>;
 
   map() : base() {}
+  explicit map(const allocator& alloc) : base(alloc) {}
   map(std::initializer_list<std::pair<Key, T>> const& items);
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  map(input_iterator first, input_iterator last) : base(first, last) {}
   map(const map& other) : base(other) {}
+  map(const map& other, const parallel_options& options)
+      : base(other, options) {}
   map(map&& other) noexcept : base(std::move(other)) {}
   ~map() = default;
 
   map& operator=(map&& other) noexcept;
 
-  T& at(const Key& key);
+  mapped_reference at(const Key& key);
   const T& at(const Key& key) const;
-  T& operator[](const Key& key);
+  mapped_reference operator[](const Key& key);
+  mapped_reference operator[](Key&& key);
 
   iterator begin() { return base::begin(); }
   iterator end() { return base::end(); }
-  iterator find(const Key& key) { return base::find(std::make_pair(key, T{})); }
+  reverse_iterator rbegin() { return base::rbegin(); }
+  reverse_iterator rend() { return base::rend(); }
+  iterator find(const Key& key) { return base::find(key); }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  iterator find(const other_key& key) {
+    return base::find(key);
+  }
 
   const_iterator cbegin() const { return base::cbegin(); }
   const_iterator cend() const { return base::cend(); }
-  const_iterator find(const Key& key) const {
-    return base::find(std::make_pair(key, T{}));
+  const_reverse_iterator crbegin() const { return base::crbegin(); }
+  const_reverse_iterator crend() const { return base::crend(); }
+  const_iterator find(const Key& key) const { return base::find(key); }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  const_iterator find(const other_key& key) const {
+    return base::find(key);
   }
 
   bool empty() const noexcept { return base::empty(); }
@@ -52,22 +82,286 @@ class map : public rb_tree<std::pair<Key, T>, compare> {
   std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
     return this->insert_data(value);
   }
+  std::pair<iterator, bool> insert(std::pair<Key, T>&& value) {
+    return this->insert_value(true, std::move(value));
+  }
+  iterator insert(const_iterator hint, const std::pair<Key, T>& value) {
+    return this->insert_hint_value(true, hint, value).first;
+  }
+  iterator insert(const_iterator hint, std::pair<Key, T>&& value) {
+    return this->insert_hint_value(true, hint, std::move(value)).first;
+  }
+  insert_return_type insert(node_type&& handle);
+  iterator insert(const_iterator hint, node_type&& handle) {
+    return this->insert_handle(true, hint, handle).first;
+  }
+  node_type extract(const_iterator pos) { return base::extract(pos); }
+  node_type extract(const Key& key) { return base::extract(key); }
   std::pair<iterator, bool> insert(const Key& key, const T& obj);
   std::pair<iterator, bool> insert_or_assign(const std::pair<Key, T>& value);
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return try_emplace_key(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+  // fn(значение) правит значение по ключу на месте; false, если ключа нет
+  template <typename function>
+  bool update(const Key& key, function&& fn);
   void erase(iterator pos) { base::erase(pos); }
+  iterator erase(const_iterator first, const_iterator last) {
+    return base::erase(first, last);
+  }
   void swap(map& other) noexcept { base::swap(other); }
   void merge(map& other) { base::merge(other); }
+  // split забирает все узлы: в first ключи меньше key, в second остальные.
+  // O(log n) с политикой subtree_size, иначе O(log n + min(|first|,
+  // |second|)) на подсчёт размеров. Половины делят пул узлов, но их можно
+  // менять из разных потоков
+  std::pair<map, map> split(const Key& key) {
+    std::pair<map, map> parts;
+    this->split_into(key, parts.first, parts.second);
+    return parts;
+  }
+  // все ключи left должны предшествовать ключам right
+  static map join(map&& left, map&& right) {
+    map result;
+    result.join_trees(left, right);
+    return result;
+  }
+  static map join(map&& left, const std::pair<Key, T>& pivot, map&& right) {
+    map result;
+    result.join_trees_with(left, right, pivot);
+    return result;
+  }
+  // операции над множествами забирают узлы обоих деревьев; из равных
+  // ключей остаются узлы left
+  static map set_union(map&& left, map&& right,
+                       const parallel_options& options = parallel_options()) {
+    return combine(left, right, base::set_operation::union_of, options);
+  }
+  static map set_intersection(
+      map&& left, map&& right,
+      const parallel_options& options = parallel_options()) {
+    return combine(left, right, base::set_operation::intersection_of, options);
+  }
+  static map set_difference(
+      map&& left, map&& right,
+      const parallel_options& options = parallel_options()) {
+    return combine(left, right, base::set_operation::difference_of, options);
+  }
   bool contains(const Key& key) const {
     return this->find(key) != this->cend();
   }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  bool contains(const other_key& key) const {
+    return this->find(key) != this->cend();
+  }
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+ private:
+  static map combine(map& left, map& right,
+                     typename base::set_operation operation,
+                     const parallel_options& options) {
+    map result;
+    result.combine_trees(left, right, operation, options);
+    return result;
+  }
+  template <typename key_arg, typename... Args>
+  std::pair<iterator, bool> try_emplace_key(key_arg&& key, Args&&... args);
+  // агрегат monoid_augment зависит от значений: после замены значения он
+  // пересчитывается до корня
+  void refresh_aggregate(typename base::node* node_curr) noexcept {
+    if constexpr (base::read_only_values) this->update_path(node_curr);
+  }
+};
+
+// map на B+-дереве: пары лежат в листьях, во внутренних узлах только ключи
+template <typename Key, typename T, typename compare, typename allocator,
+          size_t fanout>
+class map<Key, T, compare, allocator, b_tree_nodes<fanout>>
+    : public b_tree<std::pair<Key, T>, compare, allocator, select_first,
+                    fanout> {
+  using base =
+      b_tree<std::pair<Key, T>, compare, allocator, select_first, fanout>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+  using reverse_iterator = typename base::reverse_iterator;
+  using const_reverse_iterator = typename base::const_reverse_iterator;
+
+  map() : base() {}
+  explicit map(const allocator& alloc) : base(alloc) {}
+  map(std::initializer_list<std::pair<Key, T>> const& items)
+      : base(items.begin(), items.end()) {}
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  map(input_iterator first, input_iterator last) : base(first, last) {}
+  map(const map& other) : base(other) {}
+  map(map&& other) noexcept : base(std::move(other)) {}
+  ~map() = default;
+  map& operator=(map&& other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  T& at(const Key& key);
+  const T& at(const Key& key) const;
+  T& operator[](const Key& key) { return try_emplace(key).first->second; }
+  T& operator[](Key&& key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
+    return this->insert_value(true, value);
+  }
+  std::pair<iterator, bool> insert(std::pair<Key, T>&& value) {
+    return this->insert_value(true, std::move(value));
+  }
+  iterator insert(const_iterator hint, const std::pair<Key, T>& value) {
+    return this->insert_hint_value(true, hint, value).first;
+  }
+  iterator insert(const_iterator hint, std::pair<Key, T>&& value) {
+    return this->insert_hint_value(true, hint, std::move(value)).first;
+  }
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return try_emplace(key, obj);
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+    auto result = try_emplace(key, std::forward<M>(obj));
+    if (!result.second) {
+      result.first->second = std::forward<M>(obj);
+    }
+    return result;
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return this->emplace_value(true, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return try_emplace_key(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+  void swap(map& other) noexcept { base::swap(other); }
+  void merge(map& other) { this->merge_values(other, true); }
+
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    std::vector<std::pair<iterator, bool>> results;
+    (results.emplace_back(this->insert(std::forward<Args>(args))), ...);
+    return results;
+  }
+
+ private:
+  template <typename key_arg, typename... Args>
+  std::pair<iterator, bool> try_emplace_key(key_arg&& key, Args&&... args);
+};
+
+// map с неизменяемыми общими узлами: копия и snapshot() делят дерево за
+// O(1), запись копирует только общие узлы своего пути. Итераторы, at и
+// operator[] только читают: ссылка на значение осталась бы у узла, который
+// следующий snapshot() сделает общим. Значение меняется через
+// insert_or_assign и update
+template <typename Key, typename T, typename compare, typename allocator>
+class map<Key, T, compare, allocator, persistent_nodes>
+    : public persistent_tree<std::pair<Key, T>, compare, allocator,
+                             select_first> {
+  using base =
+      persistent_tree<std::pair<Key, T>, compare, allocator, select_first>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+
+  map() : base() {}
+  explicit map(const allocator& alloc) : base(alloc) {}
+  map(std::initializer_list<std::pair<Key, T>> const& items)
+      : base(items.begin(), items.end()) {}
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  map(input_iterator first, input_iterator last) : base(first, last) {}
+  map(const map& other) noexcept : base(other) {}
+  map(map&& other) noexcept : base(std::move(other)) {}
+  ~map() = default;
+  map& operator=(const map& other) noexcept {
+    base::operator=(other);
+    return *this;
+  }
+  map& operator=(map&& other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  // текущая версия для читателя в другом потоке
+  map snapshot() const noexcept { return *this; }
+
+  const T& at(const Key& key) const;
+  // вставляет значение по умолчанию, если ключа нет
+  const T& operator[](const Key& key) { return try_emplace(key).first->second; }
+  const T& operator[](Key&& key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
+    return try_emplace(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(std::pair<Key, T>&& value) {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return try_emplace(key, obj);
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return try_emplace_key(key, std::forward<Args>(args)...);
+  }
   template <typename... Args>
-  std::vector<std::pair<typename map<Key, T, compare>::iterator, bool>>
-  insert_many(Args&&... args);
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+  // fn(значение) правит значение в собственной копии узла, снимки его не
+  // видят; false, если ключа нет
+  template <typename function>
+  bool update(const Key& key, function&& fn);
+  void erase(const_iterator pos) {
+    // ключ копируется: узел с ним может быть разрушен посреди удаления
+    Key key = pos->first;
+    base::erase(key);
+  }
+  size_t erase(const Key& key) { return base::erase(key); }
+  void swap(map& other) noexcept { base::swap(other); }
+
+ private:
+  template <typename key_arg, typename... Args>
+  std::pair<iterator, bool> try_emplace_key(key_arg&& key, Args&&... args);
 };
 }  // namespace s21
 
-template <typename Key, typename T, typename compare>
-s21::map<Key, T, compare>::map(
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+s21::map<Key, T, compare, allocator, augment>::map(
     std::initializer_list<std::pair<Key, T>> const& items)
     : base() {
   for (const auto& item : items) {
@@ -75,17 +369,20 @@ s21::map<Key, T, compare>::map(
   }
 }
 
-template <typename Key, typename T, typename compare>
-s21::map<Key, T, compare>& s21::map<Key, T, compare>::operator=(
-    map&& other) noexcept {
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+s21::map<Key, T, compare, allocator, augment>&
+s21::map<Key, T, compare, allocator, augment>::operator=(map&& other) noexcept {
   if (this != &other) {
     base::operator=(std::move(other));
   }
   return *this;
 }
 
-template <typename Key, typename T, typename compare>
-T& s21::map<Key, T, compare>::at(const Key& key) {
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+typename s21::map<Key, T, compare, allocator, augment>::mapped_reference
+s21::map<Key, T, compare, allocator, augment>::at(const Key& key) {
   auto it = this->find(key);
   if (it == this->end()) {
     throw std::out_of_range("map::at");
@@ -93,8 +390,10 @@ T& s21::map<Key, T, compare>::at(const Key& key) {
   return it->second;
 }
 
-template <typename Key, typename T, typename compare>
-const T& s21::map<Key, T, compare>::at(const Key& key) const {
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+const T& s21::map<Key, T, compare, allocator, augment>::at(
+    const Key& key) const {
   auto it = this->find(key);
   if (it == this->cend()) {
     throw std::out_of_range("map::at");
@@ -102,37 +401,207 @@ const T& s21::map<Key, T, compare>::at(const Key& key) const {
   return it->second;
 }
 
-template <typename Key, typename T, typename compare>
-T& s21::map<Key, T, compare>::operator[](const Key& key) {
-  auto result = this->insert(std::make_pair(key, T{}));
-  return result.first->second;
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+typename s21::map<Key, T, compare, allocator, augment>::mapped_reference
+s21::map<Key, T, compare, allocator, augment>::operator[](const Key& key) {
+  return try_emplace(key).first->second;
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+typename s21::map<Key, T, compare, allocator, augment>::mapped_reference
+s21::map<Key, T, compare, allocator, augment>::operator[](Key&& key) {
+  return try_emplace(std::move(key)).first->second;
 }
 
-template <typename Key, typename T, typename compare>
-std::pair<typename s21::map<Key, T, compare>::iterator, bool>
-s21::map<Key, T, compare>::insert(const Key& key, const T& obj) {
-  std::pair<Key, T> value(key, obj);
-  return this->insert(value);
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+std::pair<typename s21::map<Key, T, compare, allocator, augment>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, augment>::insert(const Key& key,
+                                                        const T& obj) {
+  return try_emplace(key, obj);
 }
 
-template <typename Key, typename T, typename compare>
-std::pair<typename s21::map<Key, T, compare>::iterator, bool>
-s21::map<Key, T, compare>::insert_or_assign(const std::pair<Key, T>& value) {
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+std::pair<typename s21::map<Key, T, compare, allocator, augment>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, augment>::insert_or_assign(
+    const std::pair<Key, T>& value) {
   auto it = this->find(value.first);
   if (it != this->end()) {
-    it->second = value.second;
+    it.get_node()->data_.second = value.second;
+    refresh_aggregate(it.get_node());
     return {it, false};
   } else {
     return this->insert(value);
   }
 }
 
-template <typename Key, typename T, typename compare>
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+typename s21::map<Key, T, compare, allocator, augment>::insert_return_type
+s21::map<Key, T, compare, allocator, augment>::insert(node_type&& handle) {
+  auto result = this->insert_handle(true, const_iterator(), handle);
+  return insert_return_type{result.first, result.second, std::move(handle)};
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+template <typename M>
+std::pair<typename s21::map<Key, T, compare, allocator, augment>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, augment>::insert_or_assign(
+    const Key& key, M&& obj) {
+  auto result = try_emplace(key, std::forward<M>(obj));
+  if (!result.second) {
+    result.first.get_node()->data_.second = std::forward<M>(obj);
+    refresh_aggregate(result.first.get_node());
+  }
+  return result;
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+template <typename function>
+bool s21::map<Key, T, compare, allocator, augment>::update(const Key& key,
+                                                            function&& fn) {
+  typename base::node* found = this->find_node(key);
+  if (!found) return false;
+  try {
+    fn(found->data_.second);
+  } catch (...) {
+    refresh_aggregate(found);
+    throw;
+  }
+  refresh_aggregate(found);
+  return true;
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
+template <typename key_arg, typename... Args>
+std::pair<typename s21::map<Key, T, compare, allocator, augment>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, augment>::try_emplace_key(
+    key_arg&& key, Args&&... args) {
+  // значение строится только если ключа ещё нет в дереве
+  auto position = this->find_insert_position(key, true);
+  if (position.existing_) {
+    return std::make_pair(iterator(position.existing_, this), false);
+  }
+  typename base::node* new_node = this->create_node(
+      position.parent_, std::piecewise_construct,
+      std::forward_as_tuple(std::forward<key_arg>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+  this->link_node(new_node, position);
+  return std::make_pair(iterator(new_node, this), true);
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          typename augment>
 template <typename... Args>
-std::vector<std::pair<typename s21::map<Key, T, compare>::iterator, bool>>
-s21::map<Key, T, compare>::insert_many(Args&&... args) {
+std::vector<std::pair<
+    typename s21::map<Key, T, compare, allocator, augment>::iterator, bool>>
+s21::map<Key, T, compare, allocator, augment>::insert_many(Args&&... args) {
   std::vector<std::pair<iterator, bool>> results;
   (results.emplace_back(this->insert(std::forward<Args>(args))), ...);
   return results;
 }
+
+template <typename Key, typename T, typename compare, typename allocator,
+          size_t fanout>
+T& s21::map<Key, T, compare, allocator, s21::b_tree_nodes<fanout>>::at(
+    const Key& key) {
+  auto it = this->find(key);
+  if (it == this->end()) {
+    throw std::out_of_range("map::at");
+  }
+  return it->second;
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          size_t fanout>
+const T& s21::map<Key, T, compare, allocator, s21::b_tree_nodes<fanout>>::at(
+    const Key& key) const {
+  auto it = this->find(key);
+  if (it == this->cend()) {
+    throw std::out_of_range("map::at");
+  }
+  return it->second;
+}
+
+template <typename Key, typename T, typename compare, typename allocator,
+          size_t fanout>
+template <typename key_arg, typename... Args>
+std::pair<typename s21::map<Key, T, compare, allocator,
+                            s21::b_tree_nodes<fanout>>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, s21::b_tree_nodes<fanout>>::
+    try_emplace_key(key_arg&& key, Args&&... args) {
+  auto position = this->find_insert_position(key, true);
+  if (position.existing_) {
+    return {iterator(position.leaf_, position.index_, this), false};
+  }
+  std::pair<Key, T> value(std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<key_arg>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+  return {this->insert_at(position, std::move(value)), true};
+}
+
+template <typename Key, typename T, typename compare, typename allocator>
+const T& s21::map<Key, T, compare, allocator, s21::persistent_nodes>::at(
+    const Key& key) const {
+  auto found = this->find_node(key);
+  if (!found) {
+    throw std::out_of_range("map::at");
+  }
+  return found->data_.second;
+}
+
+template <typename Key, typename T, typename compare, typename allocator>
+template <typename M>
+std::pair<typename s21::map<Key, T, compare, allocator,
+                            s21::persistent_nodes>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, s21::persistent_nodes>::insert_or_assign(
+    const Key& key, M&& obj) {
+  auto found = this->unique_path(key);
+  if (found) {
+    found->data_.second = std::forward<M>(obj);
+    return {this->find(key), false};
+  }
+  this->insert_leaf(key, std::forward<M>(obj));
+  return {this->find(key), true};
+}
+
+template <typename Key, typename T, typename compare, typename allocator>
+template <typename key_arg, typename... Args>
+std::pair<typename s21::map<Key, T, compare, allocator,
+                            s21::persistent_nodes>::iterator,
+          bool>
+s21::map<Key, T, compare, allocator, s21::persistent_nodes>::try_emplace_key(
+    key_arg&& key, Args&&... args) {
+  // существующий ключ ничего не копирует
+  if (this->find_node(key)) {
+    return {this->find(key), false};
+  }
+  this->unique_path(key);
+  auto leaf = this->insert_leaf(
+      std::piecewise_construct,
+      std::forward_as_tuple(std::forward<key_arg>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+  return {this->find(leaf->data_.first), true};
+}
+
+template <typename Key, typename T, typename compare, typename allocator>
+template <typename function>
+bool s21::map<Key, T, compare, allocator, s21::persistent_nodes>::update(
+    const Key& key, function&& fn) {
+  if (!this->find_node(key)) return false;
+  fn(this->unique_path(key)->data_.second);
+  return true;
+}
 #endif
@@ -1,21 +1,48 @@
 #ifndef S21_MULTISET
 #define S21_MULTISET
 
+#include <iterator>
+#include <utility>
+
+#include "b_tree/b_tree.h"
 #include "red_black_tree/rb_tree.h"
+#include "s21_map.h"
 
 namespace s21 {
 
-template <typename data_type, typename compare = std::less<data_type>>
-class multiset : public rb_tree<data_type, compare> {
-  using base = rb_tree<data_type, compare>;
+// Политика узлов для multiset: один узел на каждый различный ключ и
+// счётчик его повторов. count, insert и erase_one стоят O(log n) при
+// любом числе дубликатов, а обход по-прежнему выдаёт каждый повтор.
+// Дубликаты неразличимы: хранится одна копия ключа, итераторы только
+// константные.
+struct counted_nodes {};
+
+template <typename data_type, typename compare = std::less<data_type>,
+          typename allocator = std::allocator<data_type>,
+          typename augment = no_augment>
+class multiset
+    : public rb_tree<data_type, compare, allocator, identity_key, augment> {
+  using base = rb_tree<data_type, compare, allocator, identity_key, augment>;
 
  public:
   using iterator = typename base::iterator;
   using const_iterator = typename base::const_iterator;
+  using reverse_iterator = typename base::reverse_iterator;
+  using const_reverse_iterator = typename base::const_reverse_iterator;
+  using node_type = typename base::node_handle;
 
   multiset() : base() {}
+  explicit multiset(const allocator& alloc) : base(alloc) {}
   multiset(std::initializer_list<data_type> const& items);
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  multiset(input_iterator first, input_iterator last) {
+    this->assign_range(first, last, false);
+  }
   multiset(const multiset& other) : base(other) {}
+  multiset(const multiset& other, const parallel_options& options)
+      : base(other, options) {}
   multiset(multiset&& other) noexcept : base(std::move(other)) {}
   ~multiset() = default;  // +
 
@@ -23,48 +50,377 @@ class multiset : public rb_tree<data_type, compare> {
 
   iterator begin() { return base::begin(); }
   iterator end() { return base::end(); }
+  reverse_iterator rbegin() { return base::rbegin(); }
+  reverse_iterator rend() { return base::rend(); }
   iterator find(const data_type& value) { return base::find(value); }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  iterator find(const other_key& key) {
+    return base::find(key);
+  }
 
   const_iterator cbegin() const { return base::cbegin(); }
   const_iterator cend() const { return base::cend(); }
+  const_reverse_iterator crbegin() const { return base::crbegin(); }
+  const_reverse_iterator crend() const { return base::crend(); }
   const_iterator find(const data_type& value) const {
     return base::find(value);
   }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  const_iterator find(const other_key& key) const {
+    return base::find(key);
+  }
 
   bool empty() const noexcept { return base::empty(); }
   size_t size() const noexcept { return base::size(); }
   size_t max_size() const noexcept { return base::max_size(); }
 
   void clear() { base::clear(); }
-  iterator insert(const data_type& value) { return insert_data(value).first; }
-  void erase(iterator pos);
+  template <typename input_iterator>
+  void assign_sorted(input_iterator first, input_iterator last) {
+    this->assign_range(first, last, false);
+  }
+  iterator insert(const data_type& value) {
+    return this->insert_data(value).first;
+  }
+  iterator insert(data_type&& value) {
+    return this->insert_value(false, std::move(value)).first;
+  }
+  iterator insert(const_iterator hint, const data_type& value) {
+    return this->insert_hint_value(false, hint, value).first;
+  }
+  iterator insert(const_iterator hint, data_type&& value) {
+    return this->insert_hint_value(false, hint, std::move(value)).first;
+  }
+  iterator insert(node_type&& handle) {
+    return this->insert_handle(false, const_iterator(), handle).first;
+  }
+  iterator insert(const_iterator hint, node_type&& handle) {
+    return this->insert_handle(false, hint, handle).first;
+  }
+  node_type extract(const_iterator pos) { return base::extract(pos); }
+  node_type extract(const data_type& key) {
+    iterator pos = this->lower_bound(key);
+    if (pos == end() || this->compare_(key, *pos)) return node_type();
+    return base::extract(pos);
+  }
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return this->emplace_value(false, std::forward<Args>(args)...).first;
+  }
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return this
+        ->emplace_hint_value(false, hint, std::forward<Args>(args)...)
+        .first;
+  }
+  void erase(iterator pos) { base::erase(pos); }
+  iterator erase(const_iterator first, const_iterator last) {
+    return base::erase(first, last);
+  }
   void swap(multiset& other) noexcept { base::swap(other); }
   void merge(multiset& other) { base::merge(other); }
+  // split забирает все узлы: в first ключи меньше key, в second остальные.
+  // O(log n) с политикой subtree_size, иначе O(log n + min(|first|,
+  // |second|)) на подсчёт размеров. Половины делят пул узлов, но их можно
+  // менять из разных потоков
+  std::pair<multiset, multiset> split(const data_type& key) {
+    std::pair<multiset, multiset> parts;
+    this->split_into(key, parts.first, parts.second);
+    return parts;
+  }
+  // все ключи left должны предшествовать ключам right
+  static multiset join(multiset&& left, multiset&& right) {
+    multiset result;
+    result.join_trees(left, right);
+    return result;
+  }
+  static multiset join(multiset&& left, const data_type& pivot,
+                       multiset&& right) {
+    multiset result;
+    result.join_trees_with(left, right, pivot);
+    return result;
+  }
+  // операции над множествами забирают узлы обоих деревьев; из равных
+  // ключей остаются узлы left
+  static multiset set_union(
+      multiset&& left, multiset&& right,
+      const parallel_options& options = parallel_options()) {
+    return combine(left, right, base::set_operation::union_of, options);
+  }
+  static multiset set_intersection(
+      multiset&& left, multiset&& right,
+      const parallel_options& options = parallel_options()) {
+    return combine(left, right, base::set_operation::intersection_of, options);
+  }
+  static multiset set_difference(
+      multiset&& left, multiset&& right,
+      const parallel_options& options = parallel_options()) {
+    return combine(left, right, base::set_operation::difference_of, options);
+  }
   bool contains(const data_type& key) const {
     return this->find(key) != this->cend();
   }
+  // O(log n + count): повторы обходятся по одному, за O(log n) считает
+  // multiset с counted_nodes
+  size_t count(const data_type& key) const {
+    auto range = this->equal_range(key);
+    return std::distance(range.first, range.second);
+  }
+
+ private:
+  static multiset combine(multiset& left, multiset& right,
+                          typename base::set_operation operation,
+                          const parallel_options& options) {
+    multiset result;
+    result.combine_trees(left, right, operation, options);
+    return result;
+  }
+  bool unique_keys() const noexcept override { return false; }
+};
+
+// multiset на B+-дереве: равные ключи лежат подряд в листьях
+template <typename data_type, typename compare, typename allocator,
+          size_t fanout>
+class multiset<data_type, compare, allocator, b_tree_nodes<fanout>>
+    : public b_tree<data_type, compare, allocator, identity_key, fanout> {
+  using base = b_tree<data_type, compare, allocator, identity_key, fanout>;
+
+ public:
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+  using reverse_iterator = typename base::reverse_iterator;
+  using const_reverse_iterator = typename base::const_reverse_iterator;
+
+  multiset() : base() {}
+  explicit multiset(const allocator& alloc) : base(alloc) {}
+  multiset(std::initializer_list<data_type> const& items) {
+    this->assign_range(items.begin(), items.end(), false);
+  }
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  multiset(input_iterator first, input_iterator last) {
+    this->assign_range(first, last, false);
+  }
+  multiset(const multiset& other) : base(other) {}
+  multiset(multiset&& other) noexcept : base(std::move(other)) {}
+  ~multiset() = default;
+  multiset& operator=(multiset&& other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  iterator insert(const data_type& value) {
+    return this->insert_value(false, value).first;
+  }
+  iterator insert(data_type&& value) {
+    return this->insert_value(false, std::move(value)).first;
+  }
+  iterator insert(const_iterator hint, const data_type& value) {
+    return this->insert_hint_value(false, hint, value).first;
+  }
+  iterator insert(const_iterator hint, data_type&& value) {
+    return this->insert_hint_value(false, hint, std::move(value)).first;
+  }
+  template <typename... Args>
+  iterator emplace(Args&&... args) {
+    return this->emplace_value(false, std::forward<Args>(args)...).first;
+  }
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return this
+        ->emplace_hint_value(false, hint, std::forward<Args>(args)...)
+        .first;
+  }
+  void swap(multiset& other) noexcept { base::swap(other); }
+  void merge(multiset& other) { this->merge_values(other, false); }
+};
+
+// multiset со счётчиками: узел s21::map хранит ключ и число его повторов
+template <typename data_type, typename compare, typename allocator>
+class multiset<data_type, compare, allocator, counted_nodes> {
+  using count_allocator = typename std::allocator_traits<
+      allocator>::template rebind_alloc<std::pair<data_type, size_t>>;
+  using count_map = map<data_type, size_t, compare, count_allocator>;
+  using run_iterator = typename count_map::iterator;
+  using const_run_iterator = typename count_map::const_iterator;
+
+ public:
+  using key_type = data_type;
+  using value_type = data_type;
+  using size_type = size_t;
+  class const_iterator;
+  using iterator = const_iterator;
+  using reverse_iterator = std::reverse_iterator<const_iterator>;
+  using const_reverse_iterator = reverse_iterator;
+
+  multiset() = default;
+  multiset(std::initializer_list<data_type> const& items)
+      : multiset(items.begin(), items.end()) {}
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  multiset(input_iterator first, input_iterator last) {
+    for (; first != last; ++first) insert(*first);
+  }
+  multiset(const multiset& other) = default;
+  multiset(multiset&& other) noexcept
+      : runs_(std::move(other.runs_)), size_(other.size_) {
+    other.size_ = 0;
+  }
+  ~multiset() = default;
+  multiset& operator=(multiset&& other) noexcept {
+    if (this != &other) {
+      runs_ = std::move(other.runs_);
+      size_ = other.size_;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  const_iterator begin() const { return const_iterator(runs_.cbegin(), 0); }
+  const_iterator end() const { return const_iterator(runs_.cend(), 0); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+  bool empty() const noexcept { return size_ == 0; }
+  // общее число значений вместе с повторами
+  size_t size() const noexcept { return size_; }
+  // число узлов, то есть различных ключей
+  size_t distinct_count() const noexcept { return runs_.size(); }
+  size_t max_size() const noexcept {
+    return std::numeric_limits<size_t>::max();
+  }
+
+  void clear() {
+    runs_.clear();
+    size_ = 0;
+  }
+  // новый повтор встаёт в конец серии равных ключей
+  iterator insert(const data_type& value) { return insert(value, 1); }
+  iterator insert(const data_type& value, size_t copies);
+  // убирает один повтор key; false, если ключа нет
+  bool erase_one(const data_type& key);
+  // итератор на значение, следующее за удалённым
+  iterator erase(const_iterator pos);
+  // удаляет все повторы, возвращает их число
+  size_t erase(const data_type& key);
+  void swap(multiset& other) noexcept {
+    runs_.swap(other.runs_);
+    std::swap(size_, other.size_);
+  }
+  // счётчики other прибавляются к своим, other становится пустым
+  void merge(multiset& other);
+
+  size_t count(const data_type& key) const {
+    const_run_iterator run = runs_.find(key);
+    return run == runs_.cend() ? 0 : run->second;
+  }
+  bool contains(const data_type& key) const { return runs_.contains(key); }
+  const_iterator find(const data_type& key) const {
+    return const_iterator(runs_.find(key), 0);
+  }
+  const_iterator lower_bound(const data_type& key) const {
+    return const_iterator(runs_.lower_bound(key), 0);
+  }
+  const_iterator upper_bound(const data_type& key) const {
+    return const_iterator(runs_.upper_bound(key), 0);
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const data_type& key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  // fn(key, count) для каждого различного ключа по порядку
+  template <typename function>
+  void for_each_run(function&& fn) const {
+    for (const_run_iterator run = runs_.cbegin(); run != runs_.cend(); ++run) {
+      fn(run->first, run->second);
+    }
+  }
+
+ private:
+  count_map runs_;
+  size_t size_ = 0;
+
+  // счётчик серии меняют только неконстантные методы: пустой erase
+  // превращает константный итератор в изменяемый за O(1)
+  run_iterator mutable_run(const_run_iterator run) {
+    return runs_.erase(run, run);
+  }
+};
 
-  iterator upper_bound(const data_type& key);
-  iterator lower_bound(const data_type& key);
+// итератор проходит серию из count повторов одного узла
+template <typename data_type, typename compare, typename allocator>
+class multiset<data_type, compare, allocator, counted_nodes>::const_iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = data_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const data_type*;
+  using reference = const data_type&;
 
-  std::pair<iterator, iterator> equal_range(const data_type& value);
+  const_iterator() = default;
+  const data_type& operator*() const { return (*run_).first; }
+  const data_type* operator->() const { return &(*run_).first; }
+  const_iterator& operator++() {
+    if (++index_ == run_->second) {
+      ++run_;
+      index_ = 0;
+    }
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator old = *this;
+    ++*this;
+    return old;
+  }
+  const_iterator& operator--() {
+    if (index_ == 0) {
+      --run_;
+      index_ = run_->second;
+    }
+    --index_;
+    return *this;
+  }
+  const_iterator operator--(int) {
+    const_iterator old = *this;
+    --*this;
+    return old;
+  }
+  bool operator==(const const_iterator& other) const {
+    return run_ == other.run_ && index_ == other.index_;
+  }
+  bool operator!=(const const_iterator& other) const {
+    return !(*this == other);
+  }
 
  private:
-  std::pair<typename rb_tree<data_type, compare>::iterator, bool> insert_data(
-      const data_type& data) override;
+  friend class multiset;
+  const_iterator(const_run_iterator run, size_t index)
+      : run_(run), index_(index) {}
+
+  const_run_iterator run_;
+  size_t index_ = 0;
 };
 }  // namespace s21
 
-template <typename data_type, typename compare>
-s21::multiset<data_type, compare>::multiset(
+template <typename data_type, typename compare, typename allocator,
+          typename augment>
+s21::multiset<data_type, compare, allocator, augment>::multiset(
     std::initializer_list<data_type> const& items) {
   for (auto& item : items) {
     this->insert_data(item);
   }
 }
 
-template <typename data_type, typename compare>
-s21::multiset<data_type, compare>& s21::multiset<data_type, compare>::operator=(
+template <typename data_type, typename compare, typename allocator,
+          typename augment>
+s21::multiset<data_type, compare, allocator, augment>&
+s21::multiset<data_type, compare, allocator, augment>::operator=(
     multiset&& other) noexcept {
   if (this != &other) {
     base::operator=(std::move(other));
@@ -72,85 +428,60 @@ s21::multiset<data_type, compare>& s21::multiset<data_type, compare>::operator=(
   return *this;
 }
 
-template <typename data_type, typename compare>
-void s21::multiset<data_type, compare>::erase(iterator pos) {
-  const data_type& key = *pos;
-  auto range = equal_range(key);
-  for (auto it = range.first; it != range.second;) {
-    auto current = it++;
-    if (current == pos) {
-      base::erase(current);
-    }
-  }
+template <typename data_type, typename compare, typename allocator>
+typename s21::multiset<data_type, compare, allocator,
+                       s21::counted_nodes>::iterator
+s21::multiset<data_type, compare, allocator, s21::counted_nodes>::insert(
+    const data_type& value, size_t copies) {
+  if (copies == 0) return find(value);
+  run_iterator run = runs_.try_emplace(value, 0).first;
+  run->second += copies;
+  size_ += copies;
+  return const_iterator(run, run->second - 1);
 }
 
-template <typename data_type, typename compare>
-typename s21::multiset<data_type, compare>::iterator
-s21::multiset<data_type, compare>::upper_bound(const data_type& key) {
-  typename base::node* current_node = base::root_;
-  iterator upper_bound = base::end();
-  while (current_node != nullptr) {
-    if (base::compare_(key, current_node->data_)) {
-      upper_bound = iterator(current_node, this);
-      current_node = current_node->left_;
-    } else {
-      current_node = current_node->right_;
-    }
-  }
-  return upper_bound;
+template <typename data_type, typename compare, typename allocator>
+bool s21::multiset<data_type, compare, allocator,
+                   s21::counted_nodes>::erase_one(const data_type& key) {
+  run_iterator run = runs_.find(key);
+  if (run == runs_.end()) return false;
+  if (--run->second == 0) runs_.erase(run);
+  --size_;
+  return true;
 }
 
-template <typename data_type, typename compare>
-typename s21::multiset<data_type, compare>::iterator
-s21::multiset<data_type, compare>::lower_bound(const data_type& key) {
-  typename base::node* current_node = base::root_;
-  iterator lower_bound = base::end();
-  while (current_node != nullptr) {
-    if (!base::compare_(current_node->data_, key)) {
-      lower_bound = iterator(current_node, this);
-      current_node = current_node->left_;
-    } else {
-      current_node = current_node->right_;
-    }
-  }
-  return lower_bound;
+template <typename data_type, typename compare, typename allocator>
+typename s21::multiset<data_type, compare, allocator,
+                       s21::counted_nodes>::iterator
+s21::multiset<data_type, compare, allocator, s21::counted_nodes>::erase(
+    const_iterator pos) {
+  run_iterator run = mutable_run(pos.run_);
+  --size_;
+  // повторы неразличимы: уходит последний, а следующим за pos остаётся
+  // повтор с тем же номером, если он есть
+  if (--run->second > pos.index_) return pos;
+  run_iterator next = std::next(run);
+  if (run->second == 0) runs_.erase(run);
+  return const_iterator(next, 0);
 }
 
-template <typename data_type, typename compare>
-std::pair<typename s21::multiset<data_type, compare>::iterator,
-          typename s21::multiset<data_type, compare>::iterator>
-s21::multiset<data_type, compare>::equal_range(const data_type& value) {
-  iterator first = lower_bound(value);
-  iterator last = upper_bound(value);
-  return std::make_pair(first, last);
+template <typename data_type, typename compare, typename allocator>
+size_t s21::multiset<data_type, compare, allocator, s21::counted_nodes>::erase(
+    const data_type& key) {
+  run_iterator run = runs_.find(key);
+  if (run == runs_.end()) return 0;
+  size_t removed = run->second;
+  runs_.erase(run);
+  size_ -= removed;
+  return removed;
 }
 
-template <typename data_type, typename compare>
-std::pair<typename s21::multiset<data_type, compare>::iterator, bool>
-s21::multiset<data_type, compare>::insert_data(const data_type& data) {
-  typename base::node* current_node = base::root_;
-  typename base::node* parent_node = nullptr;
-  while (current_node != nullptr) {
-    parent_node = current_node;
-    if (this->compare_(data, current_node->data_)) {
-      current_node = current_node->left_;
-    } else {
-      current_node = current_node->right_;
-    }
-  }
-  typename base::node* new_node = new typename base::node(data, nullptr);
-  new_node->parent_ = parent_node;
-
-  if (parent_node == nullptr) {
-    base::root_ = new_node;
-  } else if (!this->compare_(data, parent_node->data_)) {
-    parent_node->right_ = new_node;
-  } else {
-    parent_node->left_ = new_node;
-  }
-  this->fix_violation(new_node);
-  ++base::size_;
-  return std::make_pair(typename base::iterator(new_node, this), true);
+template <typename data_type, typename compare, typename allocator>
+void s21::multiset<data_type, compare, allocator, s21::counted_nodes>::merge(
+    multiset& other) {
+  if (this == &other) return;
+  for (const auto& run : other.runs_) insert(run.first, run.second);
+  other.clear();
 }
 
 #endif
\ No newline at end of file
@@ -3,33 +3,63 @@
 
 #include <vector>
 
+#include "b_tree/b_tree.h"
 #include "red_black_tree/rb_tree.h"
+#include "s21_frozen_set.h"
 
 namespace s21 {
-template <typename data_type, typename compare = std::less<data_type>>
-class set : public rb_tree<data_type, compare> {
-  using base = rb_tree<data_type, compare>;
+template <typename data_type, typename compare = std::less<data_type>,
+          typename allocator = std::allocator<data_type>,
+          typename augment = no_augment>
+class set
+    : public rb_tree<data_type, compare, allocator, identity_key, augment> {
+  using base = rb_tree<data_type, compare, allocator, identity_key, augment>;
 
  public:
   using iterator = typename base::iterator;
   using const_iterator = typename base::const_iterator;
+  using reverse_iterator = typename base::reverse_iterator;
+  using const_reverse_iterator = typename base::const_reverse_iterator;
+  using node_type = typename base::node_handle;
+  using insert_return_type = typename base::insert_return_type;
 
   set() : base() {}
+  explicit set(const allocator &alloc) : base(alloc) {}
   set(std::initializer_list<data_type> const &items);
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  set(input_iterator first, input_iterator last) : base(first, last) {}
   set(const set &other) : base(other) {}
+  set(const set &other, const parallel_options &options)
+      : base(other, options) {}
   set(set &&other) noexcept : base(std::move(other)) {}
   ~set() = default;
   set &operator=(set &&other) noexcept;
 
   iterator begin() { return base::begin(); }
   iterator end() { return base::end(); }
+  reverse_iterator rbegin() { return base::rbegin(); }
+  reverse_iterator rend() { return base::rend(); }
   iterator find(const data_type &value) { return base::find(value); }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  iterator find(const other_key &key) {
+    return base::find(key);
+  }
 
   const_iterator cbegin() const { return base::cbegin(); }
   const_iterator cend() const { return base::cend(); }
+  const_reverse_iterator crbegin() const { return base::crbegin(); }
+  const_reverse_iterator crend() const { return base::crend(); }
   const_iterator find(const data_type &value) const {
     return base::find(value);
   }
+  template <typename other_key, typename cmp = compare,
+            typename = typename cmp::is_transparent>
+  const_iterator find(const other_key &key) const {
+    return base::find(key);
+  }
 
   bool empty() const noexcept { return base::empty(); }
   size_t size() const noexcept { return base::size(); }
@@ -39,28 +69,166 @@ class set : public rb_tree<data_type, compare> {
   std::pair<iterator, bool> insert(const data_type &value) {
     return this->insert_data(value);
   }
+  std::pair<iterator, bool> insert(data_type &&value) {
+    return this->insert_value(true, std::move(value));
+  }
+  iterator insert(const_iterator hint, const data_type &value) {
+    return this->insert_hint_value(true, hint, value).first;
+  }
+  iterator insert(const_iterator hint, data_type &&value) {
+    return this->insert_hint_value(true, hint, std::move(value)).first;
+  }
+  insert_return_type insert(node_type &&handle);
+  iterator insert(const_iterator hint, node_type &&handle) {
+    return this->insert_handle(true, hint, handle).first;
+  }
+  node_type extract(const_iterator pos) { return base::extract(pos); }
+  node_type extract(const data_type &key) { return base::extract(key); }
   void erase(iterator pos) { base::erase(pos); }
+  iterator erase(const_iterator first, const_iterator last) {
+    return base::erase(first, last);
+  }
   void swap(set &other) noexcept { base::swap(other); }
   void merge(set &other) { base::merge(other); }
+  // split забирает все узлы: в first ключи меньше key, в second остальные.
+  // O(log n) с политикой subtree_size, иначе O(log n + min(|first|,
+  // |second|)) на подсчёт размеров. Половины делят пул узлов, но их можно
+  // менять из разных потоков
+  std::pair<set, set> split(const data_type &key) {
+    std::pair<set, set> parts;
+    this->split_into(key, parts.first, parts.second);
+    return parts;
+  }
+  // все ключи left должны предшествовать ключам right
+  static set join(set &&left, set &&right) {
+    set result;
+    result.join_trees(left, right);
+    return result;
+  }
+  static set join(set &&left, const data_type &pivot, set &&right) {
+    set result;
+    result.join_trees_with(left, right, pivot);
+    return result;
+  }
+  // операции над множествами забирают узлы обоих деревьев; из равных
+  // ключей остаются узлы left
+  static set set_union(set &&left, set &&right,
+                       const parallel_options &options = parallel_options()) {
+    return combine(left, right, base::set_operation::union_of, options);
+  }
+  static set set_intersection(
+      set &&left, set &&right,
+      const parallel_options &options = parallel_options()) {
+    return combine(left, right, base::set_operation::intersection_of, options);
+  }
+  static set set_difference(
+      set &&left, set &&right,
+      const parallel_options &options = parallel_options()) {
+    return combine(left, right, base::set_operation::difference_of, options);
+  }
   bool contains(const data_type &key) const {
     return this->find(key) != this->cend();
   }
+  // неизменяемая копия в одном массиве для множеств, которые после
+  // заполнения только читаются; само дерево не меняется
+  frozen_set<data_type, compare> freeze() const {
+    return frozen_set<data_type, compare>::from_sorted(
+        this->cbegin(), this->size(), this->compare_);
+  }
 
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+
+ private:
+  static set combine(set &left, set &right,
+                     typename base::set_operation operation,
+                     const parallel_options &options) {
+    set result;
+    result.combine_trees(left, right, operation, options);
+    return result;
+  }
+};
+
+// set<int, std::less<int>, std::allocator<int>, b_tree_nodes<64>> хранит
+// значения в B+-дереве вместо красно-чёрного
+template <typename data_type, typename compare, typename allocator,
+          size_t fanout>
+class set<data_type, compare, allocator, b_tree_nodes<fanout>>
+    : public b_tree<data_type, compare, allocator, identity_key, fanout> {
+  using base = b_tree<data_type, compare, allocator, identity_key, fanout>;
+
+ public:
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+  using reverse_iterator = typename base::reverse_iterator;
+  using const_reverse_iterator = typename base::const_reverse_iterator;
+
+  set() : base() {}
+  explicit set(const allocator &alloc) : base(alloc) {}
+  set(std::initializer_list<data_type> const &items)
+      : base(items.begin(), items.end()) {}
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  set(input_iterator first, input_iterator last) : base(first, last) {}
+  set(const set &other) : base(other) {}
+  set(set &&other) noexcept : base(std::move(other)) {}
+  ~set() = default;
+  set &operator=(set &&other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  std::pair<iterator, bool> insert(const data_type &value) {
+    return this->insert_value(true, value);
+  }
+  std::pair<iterator, bool> insert(data_type &&value) {
+    return this->insert_value(true, std::move(value));
+  }
+  iterator insert(const_iterator hint, const data_type &value) {
+    return this->insert_hint_value(true, hint, value).first;
+  }
+  iterator insert(const_iterator hint, data_type &&value) {
+    return this->insert_hint_value(true, hint, std::move(value)).first;
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return this->emplace_value(true, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  iterator emplace_hint(const_iterator hint, Args &&...args) {
+    return this->emplace_hint_value(true, hint, std::forward<Args>(args)...)
+        .first;
+  }
+  void swap(set &other) noexcept { base::swap(other); }
+  void merge(set &other) { this->merge_values(other, true); }
+  frozen_set<data_type, compare> freeze() const {
+    return frozen_set<data_type, compare>::from_sorted(
+        this->cbegin(), this->size(), this->compare_);
+  }
+
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    std::vector<std::pair<iterator, bool>> results;
+    (results.emplace_back(this->insert(std::forward<Args>(args))), ...);
+    return results;
+  }
 };
 }  // namespace s21
 
-template <typename data_type, typename compare>
-s21::set<data_type, compare>::set(
+template <typename data_type, typename compare, typename allocator,
+          typename augment>
+s21::set<data_type, compare, allocator, augment>::set(
     std::initializer_list<data_type> const &items) {
   for (auto &item : items) {
     this->insert_data(item);
   }
 }
 
-template <typename data_type, typename compare>
-s21::set<data_type, compare> &s21::set<data_type, compare>::operator=(
+template <typename data_type, typename compare, typename allocator,
+          typename augment>
+s21::set<data_type, compare, allocator, augment> &
+s21::set<data_type, compare, allocator, augment>::operator=(
     set &&other) noexcept {
   if (this != &other) {
     base::operator=(std::move(other));
@@ -68,12 +236,22 @@ s21::set<data_type, compare> &s21::set<data_type, compare>::operator=(
   return *this;
 }
 
-template <typename data_type, typename compare>
+template <typename data_type, typename compare, typename allocator,
+          typename augment>
+typename s21::set<data_type, compare, allocator, augment>::insert_return_type
+s21::set<data_type, compare, allocator, augment>::insert(node_type &&handle) {
+  auto result = this->insert_handle(true, const_iterator(), handle);
+  return insert_return_type{result.first, result.second, std::move(handle)};
+}
+
+template <typename data_type, typename compare, typename allocator,
+          typename augment>
 template <typename... Args>
-std::vector<std::pair<typename s21::set<data_type, compare>::iterator, bool>>
-s21::set<data_type, compare>::insert_many(Args &&...args) {
+std::vector<std::pair<
+    typename s21::set<data_type, compare, allocator, augment>::iterator, bool>>
+s21::set<data_type, compare, allocator, augment>::insert_many(Args &&...args) {
   std::vector<std::pair<iterator, bool>> results;
-  (results.emplace_back(this->insert_data(std::forward<Args>(args))), ...);
+  (results.emplace_back(this->insert(std::forward<Args>(args))), ...);
   return results;
 }
 
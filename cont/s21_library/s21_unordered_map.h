@@ -0,0 +1,170 @@
+#ifndef S21_UNORDERED_MAP
+#define S21_UNORDERED_MAP
+
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "hash_table/hash_table.h"
+#include "red_black_tree/rb_tree.h"
+
+namespace s21 {
+template <typename Key, typename T, typename hash = std::hash<Key>,
+          typename key_equal = std::equal_to<Key>,
+          typename allocator = std::allocator<std::pair<Key, T>>>
+class unordered_map : public hash_table<std::pair<Key, T>, hash, key_equal,
+                                        allocator, select_first> {
+  using base =
+      hash_table<std::pair<Key, T>, hash, key_equal, allocator, select_first>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+
+  unordered_map() : base() {}
+  explicit unordered_map(const allocator& alloc) : base(alloc) {}
+  unordered_map(std::initializer_list<std::pair<Key, T>> const& items);
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  unordered_map(input_iterator first, input_iterator last) {
+    for (; first != last; ++first) insert(*first);
+  }
+  unordered_map(const unordered_map& other) : base(other) {}
+  unordered_map(unordered_map&& other) noexcept : base(std::move(other)) {}
+  ~unordered_map() = default;
+
+  unordered_map& operator=(unordered_map&& other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  T& at(const Key& key);
+  const T& at(const Key& key) const;
+  T& operator[](const Key& key) { return try_emplace(key).first->second; }
+  T& operator[](Key&& key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  std::pair<iterator, bool> insert(const std::pair<Key, T>& value) {
+    return try_emplace(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(std::pair<Key, T>&& value) {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return try_emplace(key, obj);
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj);
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return this->emplace_value(std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    return try_emplace_key(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+    return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+  }
+  void swap(unordered_map& other) noexcept { base::swap(other); }
+
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args&&... args);
+
+ private:
+  template <typename key_arg, typename... Args>
+  std::pair<iterator, bool> try_emplace_key(key_arg&& key, Args&&... args);
+};
+}  // namespace s21
+
+template <typename Key, typename T, typename hash, typename key_equal,
+          typename allocator>
+s21::unordered_map<Key, T, hash, key_equal, allocator>::unordered_map(
+    std::initializer_list<std::pair<Key, T>> const& items) {
+  this->reserve(items.size());
+  for (const auto& item : items) {
+    insert(item);
+  }
+}
+
+template <typename Key, typename T, typename hash, typename key_equal,
+          typename allocator>
+T& s21::unordered_map<Key, T, hash, key_equal, allocator>::at(const Key& key) {
+  auto it = this->find(key);
+  if (it == this->end()) {
+    throw std::out_of_range("unordered_map::at");
+  }
+  return it->second;
+}
+
+template <typename Key, typename T, typename hash, typename key_equal,
+          typename allocator>
+const T& s21::unordered_map<Key, T, hash, key_equal, allocator>::at(
+    const Key& key) const {
+  auto it = this->find(key);
+  if (it == this->cend()) {
+    throw std::out_of_range("unordered_map::at");
+  }
+  return it->second;
+}
+
+template <typename Key, typename T, typename hash, typename key_equal,
+          typename allocator>
+template <typename M>
+std::pair<typename s21::unordered_map<Key, T, hash, key_equal,
+                                      allocator>::iterator,
+          bool>
+s21::unordered_map<Key, T, hash, key_equal, allocator>::insert_or_assign(
+    const Key& key, M&& obj) {
+  auto result = try_emplace(key, std::forward<M>(obj));
+  if (!result.second) {
+    result.first->second = std::forward<M>(obj);
+  }
+  return result;
+}
+
+template <typename Key, typename T, typename hash, typename key_equal,
+          typename allocator>
+template <typename key_arg, typename... Args>
+std::pair<typename s21::unordered_map<Key, T, hash, key_equal,
+                                      allocator>::iterator,
+          bool>
+s21::unordered_map<Key, T, hash, key_equal, allocator>::try_emplace_key(
+    key_arg&& key, Args&&... args) {
+  // значение строится только если ключа ещё нет в таблице
+  auto position = this->find_insert_position(key);
+  if (position.existing_) {
+    return std::make_pair(iterator(this, position.index_), false);
+  }
+  iterator it = this->emplace_at(
+      position, std::piecewise_construct,
+      std::forward_as_tuple(std::forward<key_arg>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+  return std::make_pair(it, true);
+}
+
+template <typename Key, typename T, typename hash, typename key_equal,
+          typename allocator>
+template <typename... Args>
+std::vector<std::pair<
+    typename s21::unordered_map<Key, T, hash, key_equal, allocator>::iterator,
+    bool>>
+s21::unordered_map<Key, T, hash, key_equal, allocator>::insert_many(
+    Args&&... args) {
+  // резерв заранее: перестройка таблицы сделала бы прежние итераторы
+  // недействительными
+  this->reserve(this->size() + sizeof...(args));
+  std::vector<std::pair<iterator, bool>> results;
+  (results.emplace_back(insert(std::forward<Args>(args))), ...);
+  return results;
+}
+
+#endif
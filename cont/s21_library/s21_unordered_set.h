@@ -0,0 +1,86 @@
+#ifndef S21_UNORDERED_SET
+#define S21_UNORDERED_SET
+
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+#include "hash_table/hash_table.h"
+#include "red_black_tree/rb_tree.h"
+
+namespace s21 {
+template <typename data_type, typename hash = std::hash<data_type>,
+          typename key_equal = std::equal_to<data_type>,
+          typename allocator = std::allocator<data_type>>
+class unordered_set
+    : public hash_table<data_type, hash, key_equal, allocator, identity_key> {
+  using base = hash_table<data_type, hash, key_equal, allocator, identity_key>;
+
+ public:
+  using key_type = data_type;
+  using value_type = data_type;
+  using iterator = typename base::iterator;
+  using const_iterator = typename base::const_iterator;
+
+  unordered_set() : base() {}
+  explicit unordered_set(const allocator &alloc) : base(alloc) {}
+  unordered_set(std::initializer_list<data_type> const &items);
+  template <typename input_iterator,
+            typename = typename std::iterator_traits<
+                input_iterator>::iterator_category>
+  unordered_set(input_iterator first, input_iterator last) {
+    for (; first != last; ++first) insert(*first);
+  }
+  unordered_set(const unordered_set &other) : base(other) {}
+  unordered_set(unordered_set &&other) noexcept : base(std::move(other)) {}
+  ~unordered_set() = default;
+  unordered_set &operator=(unordered_set &&other) noexcept {
+    base::operator=(std::move(other));
+    return *this;
+  }
+
+  std::pair<iterator, bool> insert(const data_type &value) {
+    return this->emplace_value(value);
+  }
+  std::pair<iterator, bool> insert(data_type &&value) {
+    return this->emplace_value(std::move(value));
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return this->emplace_value(std::forward<Args>(args)...);
+  }
+  void swap(unordered_set &other) noexcept { base::swap(other); }
+
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+};
+}  // namespace s21
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator>
+s21::unordered_set<data_type, hash, key_equal, allocator>::unordered_set(
+    std::initializer_list<data_type> const &items) {
+  this->reserve(items.size());
+  for (auto &item : items) {
+    insert(item);
+  }
+}
+
+template <typename data_type, typename hash, typename key_equal,
+          typename allocator>
+template <typename... Args>
+std::vector<std::pair<
+    typename s21::unordered_set<data_type, hash, key_equal,
+                                allocator>::iterator,
+    bool>>
+s21::unordered_set<data_type, hash, key_equal, allocator>::insert_many(
+    Args &&...args) {
+  // место под все значения резервируется заранее, иначе итераторы из
+  // первых результатов пропали бы при перестройке таблицы
+  this->reserve(this->size() + sizeof...(args));
+  std::vector<std::pair<iterator, bool>> results;
+  (results.emplace_back(insert(std::forward<Args>(args))), ...);
+  return results;
+}
+
+#endif
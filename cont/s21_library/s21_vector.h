@@ -79,7 +79,7 @@ class vector {
   void clear();
   iterator insert(iterator pos, const_reference value);
   void push_back(const_reference value);
-  void push_back(reference& value);
+  void push_back(T&& value);
   void pop_back();
   void swap(vector& other);
 
@@ -111,6 +111,7 @@ s21::vector<T, Allocator>::vector(std::ptrdiff_t n) : size_(n), capacity_(n) {
     throw std::length_error("vector");
   }
   data_ = allocator_.allocate(n);
+  std::uninitialized_value_construct_n(data_, n);
 }
 
 template <typename T, typename Allocator>
@@ -125,7 +126,7 @@ template <typename T, typename Allocator>
 s21::vector<T, Allocator>::vector(const vector& other)
     : size_(other.size_), capacity_(other.capacity_) {
   data_ = allocator_.allocate(capacity_);
-  std::memcpy(data_, other.data_, capacity_ * sizeof(T));
+  std::uninitialized_copy(other.data_, other.data_ + size_, data_);
 }
 
 template <typename T, typename Allocator>
@@ -140,16 +141,8 @@ template <typename T, typename Allocator>
 s21::vector<T, Allocator>& s21::vector<T, Allocator>::operator=(
     const vector& right) {
   if (this != &right) {
-    allocator_.deallocate(data_, capacity_);
-    for (size_type i = 0; i < size_; i++) {
-      (data_ + i)->~T();  // (*(data_ + i)).~T();
-    }
-    size_ = right.size_;
-    capacity_ = right.capacity_;
-    data_ = allocator_.allocate(size_);
-    for (size_type i = 0; i < size_; i++) {
-      data_[i] = right.data_[i];
-    }
+    vector copy(right);
+    swap(copy);
   }
   return *this;
 }
@@ -158,10 +151,9 @@ template <typename T, typename Allocator>
 s21::vector<T, Allocator>& s21::vector<T, Allocator>::operator=(
     vector&& right) {
   if (this != &right) {
-    allocator_.deallocate(
-        data_, capacity_);  // сначала очищаем место для нового контейнера
-    for (size_type i = 0; i < size_; i++) {
-      (data_ + i)->~T();  // для вектора векторов
+    clear();  // для вектора векторов
+    if (data_) {
+      allocator_.deallocate(data_, capacity_);
     }
     size_ = right.size_;
     capacity_ = right.capacity_;
@@ -175,6 +167,7 @@ s21::vector<T, Allocator>& s21::vector<T, Allocator>::operator=(
 
 template <typename T, typename Allocator>
 s21::vector<T, Allocator>::~vector() {
+  clear();
   if (data_) {
     allocator_.deallocate(data_, capacity_);
   }
@@ -183,7 +176,7 @@ s21::vector<T, Allocator>::~vector() {
 template <typename T, typename Allocator>
 typename s21::vector<T, Allocator>::reference s21::vector<T, Allocator>::at(
     size_type pos) {  // ОК
-  if (pos >= size_ || pos < 0) throw std::out_of_range("Index out of range");
+  if (pos >= size_) throw std::out_of_range("Index out of range");
   return data_[pos];
 }
 
@@ -237,7 +230,7 @@ s21::vector<T, Allocator>::capacity() const noexcept {
 template <typename T, typename Allocator>
 typename s21::vector<T, Allocator>::size_type
 s21::vector<T, Allocator>::max_size() const noexcept {
-  return std::numeric_limits<size_type>::max() / sizeof(T);
+  return std::numeric_limits<std::ptrdiff_t>::max() / sizeof(T);
 }
 
 template <typename T, typename Allocator>
@@ -249,9 +242,9 @@ template <typename T, typename Allocator>
 void s21::vector<T, Allocator>::reserve(size_type size) {  // О(n)
   if (size > capacity_ && size < max_size()) {
     T* new_data = allocator_.allocate(size);
-    for (size_type i = 0; i < size_; ++i) {
-      new_data[i] = std::move(data_[i]);
-    }
+    // элементы переезжают в неинициализированную память
+    std::uninitialized_move(data_, data_ + size_, new_data);
+    std::destroy(data_, data_ + size_);
     if (data_) {
       allocator_.deallocate(data_, capacity_);
     }
@@ -263,15 +256,9 @@ void s21::vector<T, Allocator>::reserve(size_type size) {  // О(n)
 template <typename T, typename Allocator>
 void s21::vector<T, Allocator>::shrink_to_fit() {
   if (size_ < capacity_) {
-    int* new_data = allocator_.allocate(size_);
-    for (size_type i = 0; i < size_; ++i) {
-      new_data[i] = std::move(
-          data_[i]);  // поскольку = перегружено для rvalue через &&, мы
-                      // избегаем копирования, то есть передается только
-                      // указатель, доступ к старым данным обрубается
-      // а копирование нужно в тех случаях, когда из копирующего(lvalue) массива
-      // не удалялись элементы
-    }
+    T* new_data = allocator_.allocate(size_);
+    std::uninitialized_move(data_, data_ + size_, new_data);
+    std::destroy(data_, data_ + size_);
     if (data_) {
       allocator_.deallocate(data_, capacity_);
     }
@@ -304,8 +291,6 @@ typename s21::vector<T, Allocator>::iterator s21::vector<T, Allocator>::insert(
     reserve(capacity_ == 0 ? 1 : capacity_ * 2);
   }
 
-  print();
-
   size_t counter = 0;
   iterator iter = end();  // end указывает на последний элемент, потому что
                           // size_ еще не увеличился
@@ -325,28 +310,33 @@ template <typename T, typename Allocator>
 void s21::vector<T, Allocator>::push_back(const_reference value) {
   // int a = 3; vec.push_back(a);
   if (size_ + 1 > capacity_) {
+    // value может лежать в этом же векторе, копия снимается до reserve
+    T copy(value);
     reserve(size_ == 0 ? 1 : capacity_ * 2);
+    ::new (static_cast<void*>(data_ + size_)) T(std::move(copy));
+  } else {
+    ::new (static_cast<void*>(data_ + size_)) T(value);
   }
-  data_[size_] = value;
   ++size_;
 }
 
 template <typename T, typename Allocator>
-void s21::vector<T, Allocator>::push_back(reference& value) {
-  if (size_ == 0) {
-    reserve(size_ + 1);  //
-  } else if (size_ + 1 > capacity_) {
-    reserve(capacity_ * 2);
+void s21::vector<T, Allocator>::push_back(T&& value) {
+  if (size_ + 1 > capacity_) {
+    T moved(std::move(value));
+    reserve(size_ == 0 ? 1 : capacity_ * 2);
+    ::new (static_cast<void*>(data_ + size_)) T(std::move(moved));
+  } else {
+    ::new (static_cast<void*>(data_ + size_)) T(std::move(value));
   }
-  data_[size_] = std::move(value);  // `value` IS ALREADY R-VALUE
   ++size_;
 }
 
 template <typename T, typename Allocator>
 void s21::vector<T, Allocator>::pop_back() {
   if (size_ > 0) {
-    data_[size_ - 1] = 0;
     --size_;
+    data_[size_].~T();
   }
 }
 
@@ -395,7 +385,7 @@ s21::vector<T, Allocator>::insert_many(iterator pos, Args&&... args) {
 template <typename T, typename Allocator>
 template <typename... Args>
 void s21::vector<T, Allocator>::insert_many_back(Args&&... args) {
-  (push_back(args), ...);
+  (push_back(std::forward<Args>(args)), ...);
 }
 
 template <typename T, typename Allocator>
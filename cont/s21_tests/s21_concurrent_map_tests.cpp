@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../s21_library/s21_concurrent_map.h"
+
+TEST(concurrent_map_test, single_thread_operations) {
+  s21::concurrent_map<int, std::string> s21_map(5);
+  EXPECT_EQ(s21_map.shard_count(), 8U);
+  EXPECT_TRUE(s21_map.insert_or_assign(1, "one"));
+  EXPECT_FALSE(s21_map.insert_or_assign(1, "uno"));
+  EXPECT_TRUE(s21_map.insert_or_assign(2, "two"));
+  EXPECT_EQ(s21_map.find(1).value(), "uno");
+  EXPECT_FALSE(s21_map.find(3).has_value());
+  EXPECT_TRUE(s21_map.erase(2));
+  EXPECT_FALSE(s21_map.erase(2));
+  EXPECT_EQ(s21_map.size(), 1U);
+  s21_map.clear();
+  EXPECT_TRUE(s21_map.empty());
+}
+
+TEST(concurrent_map_test, parallel_writers_and_readers) {
+  s21::concurrent_map<int, int> s21_map;
+  const int threads = 8;
+  const int per_thread = 2000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&s21_map, t] {
+      for (int i = 0; i < per_thread; ++i) {
+        int key = t * per_thread + i;
+        s21_map.insert_or_assign(key, key);
+        EXPECT_EQ(s21_map.find(key).value_or(-1), key);
+        if (i % 4 == 0) s21_map.erase(key);
+      }
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  EXPECT_EQ(s21_map.size(), static_cast<size_t>(threads * per_thread * 3 / 4));
+  size_t counted = 0;
+  s21_map.for_each_shard([&counted](const auto& shard) {
+    for (auto it = shard.cbegin(); it != shard.cend(); ++it) {
+      EXPECT_EQ(it->first, it->second);
+      ++counted;
+    }
+  });
+  EXPECT_EQ(counted, s21_map.size());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../s21_library/s21_flat_map.h"
+
+TEST(flat_map_test, matches_std_map) {
+  s21::flat_map<int, std::string> s21_map;
+  std::map<int, std::string> std_map;
+  for (int i = 0; i < 400; ++i) {
+    int key = i * 13 % 151;
+    s21_map[key] += std::to_string(i);
+    std_map[key] += std::to_string(i);
+  }
+  EXPECT_EQ(s21_map.size(), std_map.size());
+  auto it = s21_map.begin();
+  for (const auto& item : std_map) {
+    EXPECT_EQ(it->first, item.first);
+    EXPECT_EQ((*it).second, item.second);
+    ++it;
+  }
+  EXPECT_EQ(it, s21_map.end());
+  EXPECT_EQ(s21_map.lower_bound(75)->first, std_map.lower_bound(75)->first);
+}
+
+TEST(flat_map_test, insert_erase_and_at) {
+  s21::flat_map<std::string, int> s21_map{{"b", 2}, {"a", 1}, {"b", 3}};
+  EXPECT_EQ(s21_map.size(), 2U);
+  EXPECT_EQ(s21_map.at("b"), 2);
+  EXPECT_FALSE(s21_map.insert({"a", 5}).second);
+  EXPECT_TRUE(s21_map.insert("c", 4).second);
+  EXPECT_FALSE(s21_map.insert_or_assign("a", 7).second);
+  EXPECT_EQ(s21_map.at("a"), 7);
+  EXPECT_EQ(s21_map.erase("b"), 1U);
+  EXPECT_FALSE(s21_map.contains("b"));
+  s21_map.erase(s21_map.find("a"));
+  EXPECT_EQ(s21_map.size(), 1U);
+  EXPECT_EQ(s21_map.begin()->first, "c");
+  EXPECT_THROW(s21_map.at("a"), std::out_of_range);
+  const auto& view = s21_map;
+  EXPECT_EQ(view.find("c")->second, 4);
+}
+
+TEST(flat_map_test, insert_many_keeps_first_value) {
+  s21::flat_map<int, std::string> s21_map{{2, "two"}};
+  auto results = s21_map.insert_many(std::pair<int, std::string>{3, "three"},
+                                     std::pair<int, std::string>{2, "again"},
+                                     std::pair<int, std::string>{1, "one"},
+                                     std::pair<int, std::string>{3, "more"});
+  ASSERT_EQ(results.size(), 4U);
+  EXPECT_TRUE(results[0].second);
+  EXPECT_FALSE(results[1].second);
+  EXPECT_TRUE(results[2].second);
+  EXPECT_FALSE(results[3].second);
+  EXPECT_EQ(results[3].first->second, "three");
+  EXPECT_EQ(s21_map.at(2), "two");
+  std::vector<int> keys;
+  for (auto item : s21_map) keys.push_back(item.first);
+  EXPECT_EQ(keys, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(flat_map_test, find_batch_matches_find) {
+  s21::flat_map<int, std::string> s21_map;
+  for (int i = 0; i < 37; ++i) s21_map[i * 3] = std::to_string(i);
+  std::vector<int> keys;
+  for (int i = -1; i < 115; i += 2) keys.push_back(i);
+  std::vector<s21::flat_map<int, std::string>::iterator> found;
+  s21_map.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+  std::vector<bool> contained(keys.size());
+  s21_map.contains_batch(keys.begin(), keys.end(), contained.begin());
+  ASSERT_EQ(found.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(found[i], s21_map.find(keys[i]));
+    EXPECT_EQ(contained[i], s21_map.contains(keys[i]));
+  }
+}
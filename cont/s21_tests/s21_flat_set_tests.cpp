@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../s21_library/s21_flat_set.h"
+
+TEST(flat_set_test, constructor_sorts_and_removes_duplicates) {
+  s21::flat_set<int> s21_set{5, 1, 4, 1, 3, 5};
+  std::set<int> std_set{5, 1, 4, 1, 3, 5};
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+}
+
+TEST(flat_set_test, insert_find_erase) {
+  s21::flat_set<std::string> s21_set;
+  std::set<std::string> std_set;
+  for (int i = 0; i < 300; ++i) {
+    std::string key = "key" + std::to_string(i * 37 % 101);
+    EXPECT_EQ(s21_set.insert(key).second, std_set.insert(key).second);
+  }
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(s21_set.contains("key42"));
+  EXPECT_EQ(*s21_set.find("key42"), "key42");
+  EXPECT_EQ(s21_set.find("missing"), s21_set.end());
+  EXPECT_EQ(*s21_set.lower_bound("key5"), *std_set.lower_bound("key5"));
+  EXPECT_EQ(s21_set.erase("key42"), 1U);
+  EXPECT_EQ(s21_set.erase("key42"), 0U);
+  std_set.erase("key42");
+  s21_set.erase(s21_set.begin());
+  std_set.erase(std_set.begin());
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+}
+
+TEST(flat_set_test, insert_many_merges_once) {
+  s21::flat_set<int> s21_set{10, 20, 30};
+  auto results = s21_set.insert_many(25, 5, 20, 5, 40);
+  std::vector<int> expected{5, 10, 20, 25, 30, 40};
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), expected.begin(),
+                         expected.end()));
+  ASSERT_EQ(results.size(), 5U);
+  EXPECT_TRUE(results[0].second);
+  EXPECT_EQ(*results[0].first, 25);
+  EXPECT_TRUE(results[1].second);
+  EXPECT_FALSE(results[2].second);
+  EXPECT_FALSE(results[3].second);
+  EXPECT_EQ(*results[3].first, 5);
+  EXPECT_TRUE(results[4].second);
+}
+
+TEST(flat_set_test, copy_and_range_insert) {
+  std::vector<int> keys{9, 7, 5, 3, 1, 7};
+  s21::flat_set<int> s21_set(keys.begin(), keys.end());
+  s21::flat_set<int> copy(s21_set);
+  copy.insert(keys.begin(), keys.end());
+  EXPECT_EQ(copy.size(), 5U);
+  EXPECT_EQ(*copy.begin(), 1);
+  s21_set.clear();
+  EXPECT_TRUE(s21_set.empty());
+  EXPECT_EQ(copy.size(), 5U);
+}
+
+TEST(flat_set_test, find_batch_matches_find) {
+  for (int count : {0, 1, 2, 7, 100}) {
+    s21::flat_set<int> s21_set;
+    for (int i = 0; i < count; ++i) s21_set.insert(i * 2);
+    std::vector<int> keys;
+    for (int i = -2; i < count * 2 + 2; ++i) keys.push_back(i);
+    std::vector<const int*> found(keys.size());
+    std::vector<bool> contained(keys.size());
+    s21_set.find_batch(keys.begin(), keys.end(), found.begin());
+    s21_set.contains_batch(keys.begin(), keys.end(), contained.begin());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      EXPECT_EQ(found[i], s21_set.find(keys[i]));
+      EXPECT_EQ(contained[i], s21_set.contains(keys[i]));
+    }
+  }
+}
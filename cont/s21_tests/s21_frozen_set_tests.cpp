@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../s21_library/s21_frozen_set.h"
+#include "../s21_library/s21_set.h"
+
+TEST(frozen_set_test, constructor_sorts_and_removes_duplicates) {
+  s21::frozen_set<int> frozen{5, 1, 4, 1, 3, 5};
+  std::set<int> std_set{5, 1, 4, 1, 3, 5};
+  EXPECT_EQ(frozen.size(), std_set.size());
+  EXPECT_TRUE(std::equal(frozen.begin(), frozen.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(std::equal(frozen.rbegin(), frozen.rend(), std_set.rbegin(),
+                         std_set.rend()));
+  s21::frozen_set<int> empty;
+  EXPECT_TRUE(empty.begin() == empty.end());
+  EXPECT_FALSE(empty.contains(1));
+  EXPECT_TRUE(empty.lower_bound(1) == empty.end());
+}
+
+TEST(frozen_set_test, freeze_matches_live_set) {
+  // размеры вокруг полных уровней дерева: 2^k - 1, 2^k, 2^k + 1
+  for (int count : {1, 2, 3, 7, 8, 9, 100, 1023, 1024, 1025}) {
+    s21::set<int> live;
+    for (int i = 0; i < count; ++i) live.insert(i * 3);
+    s21::frozen_set<int> frozen = live.freeze();
+    const auto& view = live;
+    ASSERT_EQ(frozen.size(), live.size());
+    EXPECT_TRUE(std::equal(frozen.begin(), frozen.end(), live.cbegin(),
+                           live.cend()));
+    for (int key = -2; key <= count * 3 + 1; ++key) {
+      EXPECT_EQ(frozen.contains(key), live.contains(key));
+      auto lower = view.lower_bound(key);
+      auto frozen_lower = frozen.lower_bound(key);
+      ASSERT_EQ(frozen_lower == frozen.end(), lower == live.cend());
+      if (lower != live.cend()) {
+        EXPECT_EQ(*frozen_lower, *lower);
+      }
+      auto upper = view.upper_bound(key);
+      auto frozen_upper = frozen.upper_bound(key);
+      ASSERT_EQ(frozen_upper == frozen.end(), upper == live.cend());
+      if (upper != live.cend()) {
+        EXPECT_EQ(*frozen_upper, *upper);
+      }
+    }
+  }
+}
+
+TEST(frozen_set_test, copy_and_strings) {
+  s21::set<std::string> live;
+  for (int i = 0; i < 200; ++i) live.insert("key" + std::to_string(i));
+  s21::frozen_set<std::string> frozen = live.freeze();
+  s21::frozen_set<std::string> copy = frozen;
+  frozen = s21::frozen_set<std::string>();
+  EXPECT_TRUE(frozen.empty());
+  EXPECT_EQ(copy.size(), 200U);
+  EXPECT_EQ(*copy.find("key42"), "key42");
+  EXPECT_TRUE(copy.find("key") == copy.end());
+  auto last = copy.end();
+  --last;
+  EXPECT_EQ(*last, "key99");
+  std::vector<std::string> keys(copy.begin(), copy.end());
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
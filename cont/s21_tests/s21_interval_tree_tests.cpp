@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../s21_library/s21_interval_tree.h"
+
+using interval = std::pair<int, int>;
+
+static std::vector<interval> brute_overlapping(
+    const std::vector<interval>& intervals, int lo, int hi) {
+  std::vector<interval> found;
+  for (const interval& item : intervals) {
+    if (item.first < hi && lo < item.second) found.push_back(item);
+  }
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+static std::vector<interval> sorted(std::vector<interval> items) {
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+TEST(interval_tree_test, overlapping_and_stab_match_scan) {
+  s21::interval_tree<int> tree;
+  std::vector<interval> intervals;
+  std::mt19937 rng(5);
+  for (int i = 0; i < 2000; ++i) {
+    int start = static_cast<int>(rng() % 10000);
+    int length = 1 + static_cast<int>(rng() % (i % 10 == 0 ? 2000 : 50));
+    tree.insert(start, start + length);
+    intervals.emplace_back(start, start + length);
+  }
+  ASSERT_TRUE(tree.is_balanced());
+  // половина интервалов удаляется: max_end пересчитывается при fixup
+  for (int i = 0; i < 1000; ++i) {
+    size_t index = rng() % intervals.size();
+    EXPECT_TRUE(tree.erase(intervals[index].first, intervals[index].second));
+    intervals.erase(intervals.begin() + index);
+  }
+  ASSERT_TRUE(tree.is_balanced());
+  ASSERT_EQ(tree.size(), intervals.size());
+  for (int query = 0; query < 300; ++query) {
+    int lo = static_cast<int>(rng() % 11000) - 500;
+    int hi = lo + 1 + static_cast<int>(rng() % 300);
+    std::vector<interval> found;
+    tree.overlapping(lo, hi, [&found](const interval& x) {
+      found.push_back(x);
+    });
+    EXPECT_EQ(sorted(found), brute_overlapping(intervals, lo, hi));
+    found.clear();
+    tree.stab(lo, [&found](const interval& x) { found.push_back(x); });
+    EXPECT_EQ(sorted(found), brute_overlapping(intervals, lo, lo + 1));
+  }
+  int max_end = 0;
+  for (const interval& item : intervals) {
+    max_end = std::max(max_end, item.second);
+  }
+  EXPECT_EQ(tree.max_end(), max_end);
+}
+
+TEST(interval_tree_test, half_open_bounds_and_duplicates) {
+  s21::interval_tree<int> tree = {{1, 5}, {1, 3}, {5, 8}, {1, 5}};
+  EXPECT_EQ(tree.size(), 4U);
+  size_t hits = 0;
+  tree.stab(5, [&hits](const interval& x) {
+    EXPECT_EQ(x, interval(5, 8));
+    ++hits;
+  });
+  EXPECT_EQ(hits, 1U);
+  hits = 0;
+  tree.overlapping(3, 5, [&hits](const interval&) { ++hits; });
+  EXPECT_EQ(hits, 2U);
+  hits = 0;
+  tree.overlapping(4, 4, [&hits](const interval&) { ++hits; });
+  EXPECT_EQ(hits, 0U);
+  EXPECT_TRUE(tree.erase(1, 5));
+  EXPECT_TRUE(tree.erase(1, 5));
+  EXPECT_FALSE(tree.erase(1, 5));
+  EXPECT_EQ(tree.max_end(), 8);
+  tree.erase(--tree.end());
+  EXPECT_EQ(tree.max_end(), 3);
+  EXPECT_TRUE(std::equal(tree.begin(), tree.end(),
+                         std::vector<interval>{{1, 3}}.begin()));
+}
+
+TEST(interval_tree_test, string_keys) {
+  s21::interval_tree<std::string> tree;
+  tree.insert("apple", "cherry");
+  tree.insert("banana", "kiwi");
+  tree.insert("lemon", "melon");
+  std::vector<std::string> starts;
+  tree.stab("cat", [&starts](const auto& x) { starts.push_back(x.first); });
+  EXPECT_EQ(starts, (std::vector<std::string>{"apple", "banana"}));
+}
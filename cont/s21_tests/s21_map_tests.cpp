@@ -1,5 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 #include "../s21_library/s21_map.h"
 
 template <typename iterator1, typename iterator2>
@@ -171,7 +185,8 @@ TEST(map_test_eq, max_size_method) {
   s21::map<int, std::string> s21_map;
   std::map<int, std::string> std_map;
 
-  EXPECT_EQ(s21_map.max_size(), std_map.max_size());
+  // узел s21::map компактнее узла std::map, поэтому предел не меньше
+  EXPECT_GE(s21_map.max_size(), std_map.max_size());
 }
 
 TEST(map_test_eq, clear_method) {
@@ -334,4 +349,476 @@ TEST(map_insert_many_test, basic_insertion) {
   EXPECT_TRUE(my_map.contains(1));
   EXPECT_TRUE(my_map.contains(2));
   EXPECT_TRUE(my_map.contains(3));
-}
\ No newline at end of file
+}
+TEST(map_test_eq, range_constructor_keeps_first_duplicate) {
+  std::vector<std::pair<int, std::string>> items = {
+      {3, "three"}, {1, "one"}, {2, "two"}, {1, "uno"}, {4, "four"}};
+  s21::map<int, std::string> s21_map(items.begin(), items.end());
+  std::map<int, std::string> std_map(items.begin(), items.end());
+
+  EXPECT_EQ(s21_map.size(), std_map.size());
+  EXPECT_TRUE(s21_map.is_balanced());
+  EXPECT_TRUE(containers_equal(s21_map.begin(), s21_map.end(), std_map.begin(),
+                               std_map.end()));
+}
+
+TEST(map_test_eq, assign_sorted_from_sorted_snapshot) {
+  std::map<int, int> std_map;
+  for (int i = 0; i < 500; ++i) {
+    std_map[i * 2] = i;
+  }
+  s21::map<int, int> s21_map;
+  s21_map.assign_sorted(std_map.begin(), std_map.end());
+
+  EXPECT_EQ(s21_map.size(), std_map.size());
+  EXPECT_TRUE(s21_map.is_balanced());
+  EXPECT_TRUE(containers_equal(s21_map.begin(), s21_map.end(), std_map.begin(),
+                               std_map.end()));
+  EXPECT_EQ(s21_map.at(998), 499);
+}
+
+struct counted_value {
+  static inline int default_constructed = 0;
+  int value;
+
+  counted_value() : value(0) { ++default_constructed; }
+  explicit counted_value(int v) : value(v) {}
+};
+
+TEST(map_test, lookup_does_not_construct_mapped_value) {
+  s21::map<int, counted_value> s21_map;
+  s21_map.insert({1, counted_value(10)});
+  s21_map.insert({2, counted_value(20)});
+  counted_value::default_constructed = 0;
+
+  EXPECT_TRUE(s21_map.find(1) != s21_map.end());
+  EXPECT_TRUE(s21_map.find(3) == s21_map.end());
+  EXPECT_TRUE(s21_map.contains(2));
+  EXPECT_FALSE(s21_map.contains(5));
+  EXPECT_EQ(s21_map.at(2).value, 20);
+  EXPECT_EQ(s21_map[1].value, 10);
+  EXPECT_EQ(counted_value::default_constructed, 0);
+
+  s21_map[7];
+  EXPECT_EQ(counted_value::default_constructed, 1);
+}
+
+TEST(map_test, transparent_lookup_with_string_view) {
+  s21::map<std::string, int, std::less<>> s21_map{
+      {"alpha", 1}, {"beta", 2}, {"gamma", 3}};
+  std::string_view key = "beta";
+
+  auto it = s21_map.find(key);
+  ASSERT_TRUE(it != s21_map.end());
+  EXPECT_EQ(it->second, 2);
+  EXPECT_TRUE(s21_map.contains(std::string_view("gamma")));
+  EXPECT_FALSE(s21_map.contains(std::string_view("delta")));
+  EXPECT_TRUE(s21_map.find("alpha") != s21_map.end());
+
+  const auto &const_map = s21_map;
+  EXPECT_TRUE(const_map.find(key) != const_map.cend());
+}
+
+TEST(map_test_eq, custom_key_comparator) {
+  s21::map<int, std::string, std::greater<int>> s21_map{
+      {1, "one"}, {3, "three"}, {2, "two"}};
+  std::map<int, std::string, std::greater<int>> std_map{
+      {1, "one"}, {3, "three"}, {2, "two"}};
+
+  EXPECT_TRUE(containers_equal(s21_map.begin(), s21_map.end(), std_map.begin(),
+                               std_map.end()));
+  EXPECT_EQ(s21_map.at(3), "three");
+}
+
+TEST(map_test, try_emplace_skips_existing_key) {
+  s21::map<int, counted_value> s21_map;
+  auto first = s21_map.try_emplace(1, 10);
+  EXPECT_TRUE(first.second);
+  EXPECT_EQ(first.first->second.value, 10);
+
+  counted_value::default_constructed = 0;
+  auto second = s21_map.try_emplace(1);
+  EXPECT_FALSE(second.second);
+  EXPECT_TRUE(second.first == first.first);
+  EXPECT_EQ(counted_value::default_constructed, 0);
+  EXPECT_EQ(s21_map.size(), 1U);
+}
+
+TEST(map_test, move_only_values) {
+  s21::map<std::string, std::unique_ptr<int>> s21_map;
+  std::string key = "answer";
+  s21_map.try_emplace(std::move(key), new int(42));
+  s21_map.insert(std::make_pair(std::string("one"), std::make_unique<int>(1)));
+  s21_map.emplace("two", std::make_unique<int>(2));
+
+  auto value = std::make_unique<int>(7);
+  auto result = s21_map.try_emplace("one", std::move(value));
+  EXPECT_FALSE(result.second);
+  ASSERT_TRUE(value != nullptr);
+
+  s21_map.insert_or_assign("one", std::move(value));
+  EXPECT_EQ(*s21_map["one"], 7);
+  EXPECT_EQ(*s21_map.at("answer"), 42);
+  EXPECT_EQ(*s21_map.at("two"), 2);
+  EXPECT_EQ(s21_map.size(), 3U);
+}
+
+TEST(map_test, hinted_insert_existing_key) {
+  s21::map<int, std::string> s21_map;
+  for (int i = 0; i < 100; ++i) {
+    s21_map.insert(s21_map.cend(), {i, std::to_string(i)});
+  }
+  auto it = s21_map.insert(s21_map.find(42), {42, "other"});
+  EXPECT_EQ(it->second, "42");
+  EXPECT_EQ(s21_map.size(), 100U);
+  EXPECT_TRUE(s21_map.is_balanced());
+}
+
+TEST(map_test_eq, reverse_iteration) {
+  s21::map<int, std::string> s21_map{{1, "one"}, {3, "three"}, {2, "two"}};
+  std::map<int, std::string> std_map{{1, "one"}, {3, "three"}, {2, "two"}};
+  EXPECT_EQ((--s21_map.end())->second, "three");
+  EXPECT_EQ(s21_map.rbegin()->first, 3);
+  EXPECT_TRUE(containers_equal(s21_map.crbegin(), s21_map.crend(),
+                               std_map.crbegin(), std_map.crend()));
+}
+
+TEST(map_test, extract_changes_key_without_copy) {
+  s21::map<std::string, std::unique_ptr<int>> s21_map;
+  s21_map.emplace("old", std::make_unique<int>(5));
+  int *address = s21_map.at("old").get();
+
+  auto handle = s21_map.extract("old");
+  handle.key() = "new";
+  auto result = s21_map.insert(std::move(handle));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_FALSE(s21_map.contains("old"));
+  EXPECT_EQ(s21_map.at("new").get(), address);
+}
+
+TEST(map_test, maps_sharing_a_pool_work_on_separate_threads) {
+  // после обмена узлами пул у карт общий, но каждая по-прежнему
+  // используется своим потоком без внешней синхронизации
+  s21::map<int, int> first;
+  s21::map<int, int> second;
+  s21::map<int, int> third{{-1, -1}, {-2, -2}};
+  for (int i = 0; i < 100; ++i) second.insert(i, i);
+  first.insert(second.extract(0));
+  first.merge(third);
+  auto handle = second.extract(1);
+  auto churn = [](s21::map<int, int>& target, int base) {
+    for (int i = 0; i < 5000; ++i) {
+      target.insert(base + i, i);
+      if (i % 3 == 0) target.erase(target.find(base + i));
+    }
+  };
+  std::thread first_worker(churn, std::ref(first), 1000);
+  std::thread second_worker(churn, std::ref(second), 100000);
+  std::thread handle_owner([moved = std::move(handle)]() mutable {
+    EXPECT_EQ(moved.mapped(), 1);
+    moved = decltype(moved)();
+  });
+  first_worker.join();
+  second_worker.join();
+  handle_owner.join();
+  EXPECT_EQ(first.size(), 3U + 3333U);
+  EXPECT_EQ(second.size(), 98U + 3333U);
+  EXPECT_EQ(first.at(0), 0);
+  EXPECT_EQ(second.at(99), 99);
+  EXPECT_TRUE(first.is_balanced());
+  EXPECT_TRUE(second.is_balanced());
+}
+
+TEST(map_test, order_statistics_by_key) {
+  using ranked_map =
+      s21::map<int, std::string, std::less<int>,
+               std::allocator<std::pair<int, std::string>>, s21::subtree_size>;
+  ranked_map s21_map{{5, "five"}, {1, "one"}, {3, "three"}, {7, "seven"}};
+  EXPECT_EQ(s21_map.nth(2)->second, "five");
+  EXPECT_EQ(s21_map.rank(4), 2U);
+  EXPECT_EQ(s21_map.count_range(2, 7), 2U);
+}
+
+TEST(map_test, split_and_join) {
+  s21::map<int, std::string> s21_map{{1, "one"}, {2, "two"}, {3, "three"},
+                                     {4, "four"}};
+  auto parts = s21_map.split(3);
+  EXPECT_EQ(parts.first.size(), 2U);
+  EXPECT_EQ(parts.second.at(4), "four");
+  EXPECT_FALSE(parts.first.contains(3));
+
+  auto joined = s21::map<int, std::string>::join(
+      std::move(parts.second), {5, "five"}, s21::map<int, std::string>());
+  EXPECT_EQ(joined.size(), 3U);
+  EXPECT_EQ(joined.at(5), "five");
+  EXPECT_TRUE(joined.is_balanced());
+}
+
+TEST(map_test, split_halves_change_on_separate_threads) {
+  s21::map<int, int> s21_map;
+  for (int i = 0; i < 2000; ++i) s21_map.insert(i, i);
+  auto parts = s21_map.split(1000);
+  std::thread grow([&parts] {
+    for (int i = 0; i < 5000; ++i) parts.first.insert(-1 - i, i);
+  });
+  std::thread shrink([&parts] {
+    for (int i = 1000; i < 2000; ++i) parts.second.erase(parts.second.find(i));
+    for (int i = 0; i < 3000; ++i) parts.second.insert(5000 + i, i);
+  });
+  grow.join();
+  shrink.join();
+  EXPECT_EQ(parts.first.size(), 6000U);
+  EXPECT_EQ(parts.second.size(), 3000U);
+  EXPECT_EQ(parts.first.at(999), 999);
+  EXPECT_FALSE(parts.second.contains(1500));
+  EXPECT_TRUE(parts.first.is_balanced());
+  EXPECT_TRUE(parts.second.is_balanced());
+}
+
+TEST(map_test, set_union_keeps_left_values) {
+  s21::map<int, std::string> left{{1, "a"}, {2, "b"}};
+  s21::map<int, std::string> right{{2, "x"}, {3, "y"}};
+  auto united =
+      s21::map<int, std::string>::set_union(std::move(left), std::move(right));
+  EXPECT_EQ(united.size(), 3U);
+  EXPECT_EQ(united.at(2), "b");
+  EXPECT_EQ(united.at(3), "y");
+
+  auto common = s21::map<int, std::string>::set_intersection(
+      std::move(united), s21::map<int, std::string>{{3, "z"}});
+  EXPECT_EQ(common.size(), 1U);
+  EXPECT_EQ(common.at(3), "y");
+}
+
+TEST(map_test, b_tree_nodes_lookup) {
+  s21::map<int, std::string, std::less<int>,
+           std::allocator<std::pair<int, std::string>>, s21::b_tree_nodes<4>>
+      s21_map{{3, "three"}, {1, "one"}};
+  std::map<int, std::string> std_map{{3, "three"}, {1, "one"}};
+  for (int i = 0; i < 500; ++i) {
+    s21_map[i * 3 % 251] += "x";
+    std_map[i * 3 % 251] += "x";
+  }
+  EXPECT_FALSE(s21_map.insert_or_assign(1, "first").second);
+  std_map.insert_or_assign(1, "first");
+  EXPECT_FALSE(s21_map.insert(3, "other").second);
+  s21_map.erase(s21_map.find(7));
+  std_map.erase(7);
+  EXPECT_EQ(s21_map.size(), std_map.size());
+  for (const auto& item : std_map) {
+    EXPECT_EQ(s21_map.at(item.first), item.second);
+  }
+  EXPECT_THROW(s21_map.at(7), std::out_of_range);
+}
+
+using persistent_map =
+    s21::map<int, std::string, std::less<int>,
+             std::allocator<std::pair<int, std::string>>,
+             s21::persistent_nodes>;
+
+TEST(map_test, persistent_nodes_snapshot) {
+  persistent_map s21_map{{2, "two"}, {1, "one"}};
+  std::map<int, std::string> std_map{{2, "two"}, {1, "one"}};
+  for (int i = 0; i < 300; ++i) {
+    s21_map.try_emplace(i * 7 % 101);
+    s21_map.update(i * 7 % 101, [](std::string& value) { value += "x"; });
+    std_map[i * 7 % 101] += "x";
+  }
+  persistent_map snapshot = s21_map.snapshot();
+  std::map<int, std::string> std_snapshot = std_map;
+  for (int i = 0; i < 101; i += 3) {
+    EXPECT_EQ(s21_map.erase(i), std_map.erase(i));
+  }
+  s21_map.insert_or_assign(1, "first");
+  std_map.insert_or_assign(1, "first");
+  EXPECT_TRUE(
+      s21_map.update(2, [](std::string& value) { value = "second"; }));
+  std_map.at(2) = "second";
+  EXPECT_FALSE(s21_map.insert(4, "other").second);
+  EXPECT_TRUE(s21_map.try_emplace(500, "new").second);
+  std_map.try_emplace(500, "new");
+  s21_map.erase(s21_map.find(5));
+  std_map.erase(5);
+
+  EXPECT_TRUE(containers_equal(s21_map.begin(), s21_map.end(),
+                               std_map.begin(), std_map.end()));
+  EXPECT_TRUE(containers_equal(snapshot.begin(), snapshot.end(),
+                               std_snapshot.begin(), std_snapshot.end()));
+  EXPECT_EQ(s21_map.size(), std_map.size());
+  EXPECT_EQ(snapshot.size(), std_snapshot.size());
+  EXPECT_TRUE(s21_map.is_balanced());
+  EXPECT_TRUE(snapshot.is_balanced());
+  EXPECT_THROW(s21_map.at(3), std::out_of_range);
+  EXPECT_EQ(snapshot.at(3), std_snapshot.at(3));
+  EXPECT_EQ(s21_map.lower_bound(6)->first, 7);
+  EXPECT_EQ(s21_map.upper_bound(7)->first, 8);
+}
+
+TEST(map_test, persistent_nodes_values_read_only_outside_update) {
+  persistent_map s21_map{{1, "one"}};
+  static_assert(!std::is_assignable_v<decltype(s21_map[1]), std::string>);
+  static_assert(!std::is_assignable_v<decltype(s21_map.at(1)), std::string>);
+  const std::string& before = s21_map[1];
+  persistent_map snapshot = s21_map.snapshot();
+  EXPECT_TRUE(s21_map.update(1, [](std::string& value) { value = "uno"; }));
+  EXPECT_FALSE(s21_map.update(2, [](std::string& value) { value = "dos"; }));
+  EXPECT_EQ(s21_map.at(1), "uno");
+  EXPECT_EQ(snapshot.at(1), "one");
+  EXPECT_EQ(&before, &snapshot.at(1));
+  EXPECT_EQ(s21_map[3], "");
+  EXPECT_EQ(s21_map.size(), 2U);
+}
+
+TEST(map_test, persistent_nodes_readers_during_writes) {
+  // в каждой версии ключи 0..size-1 со значениями, равными ключу
+  persistent_map s21_map;
+  persistent_map published;
+  std::mutex publish_mutex;
+  bool done = false;
+  std::vector<std::thread> readers;
+  std::vector<int> failures(4);
+  for (int reader = 0; reader < 4; ++reader) {
+    readers.emplace_back([&, reader] {
+      for (;;) {
+        persistent_map version;
+        bool last = false;
+        {
+          std::lock_guard<std::mutex> lock(publish_mutex);
+          version = published;
+          last = done;
+        }
+        int expected = 0;
+        for (const auto& item : version) {
+          if (item.first != expected ||
+              item.second != std::to_string(expected)) {
+            ++failures[reader];
+          }
+          ++expected;
+        }
+        if (static_cast<size_t>(expected) != version.size()) ++failures[reader];
+        if (last) break;
+      }
+    });
+  }
+  for (int i = 0; i < 3000; ++i) {
+    s21_map.insert(i, std::to_string(i));
+    if (i % 3 == 0) s21_map.erase(i);
+    if (i % 3 == 0) s21_map.insert(i, std::to_string(i));
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    published = s21_map.snapshot();
+  }
+  {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    done = true;
+  }
+  for (auto& reader : readers) reader.join();
+  for (int count : failures) EXPECT_EQ(count, 0);
+  EXPECT_EQ(s21_map.size(), 3000u);
+  EXPECT_TRUE(s21_map.is_balanced());
+}
+
+TEST(map_test, find_batch_matches_find) {
+  s21::map<std::string, int> s21_map;
+  for (int i = 0; i < 200; i += 2) s21_map[std::to_string(i)] = i;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 50; ++i) keys.push_back(std::to_string(i * 7 % 201));
+  std::vector<s21::map<std::string, int>::const_iterator> found;
+  const auto& const_map = s21_map;
+  const_map.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(found[i], const_map.find(keys[i]));
+  }
+}
+
+TEST(map_test, bounds_and_erase_range) {
+  s21::map<int, int> s21_map;
+  for (int i = 0; i < 100; i += 2) s21_map.insert({i, i * i});
+  const auto& view = s21_map;
+  EXPECT_EQ(view.lower_bound(11)->first, 12);
+  EXPECT_EQ(view.upper_bound(12)->first, 14);
+  auto range = view.equal_range(13);
+  EXPECT_TRUE(range.first == range.second);
+  int sum = 0;
+  view.for_each_in_range(10, 20, [&sum](const auto& x) { sum += x.second; });
+  EXPECT_EQ(sum, 100 + 144 + 196 + 256 + 324);
+  s21_map.for_each_in_range(0, 10, [](auto& x) { x.second = -1; });
+  EXPECT_EQ(s21_map.at(8), -1);
+
+  auto next = s21_map.erase(s21_map.find(20), s21_map.end());
+  EXPECT_TRUE(next == s21_map.end());
+  EXPECT_EQ(s21_map.size(), 10U);
+  EXPECT_EQ((--s21_map.end())->first, 18);
+  EXPECT_TRUE(s21_map.is_balanced());
+}
+
+TEST(map_test, range_aggregates_match_scan) {
+  using sum_map = s21::map<int, long, std::less<int>,
+                           std::allocator<std::pair<int, long>>,
+                           s21::range_sum<long>>;
+  using min_map = s21::map<int, long, std::less<int>,
+                           std::allocator<std::pair<int, long>>,
+                           s21::range_min<long>>;
+  sum_map sums;
+  min_map mins;
+  std::map<int, long> std_map;
+  std::mt19937 rng(21);
+  for (int i = 0; i < 3000; ++i) {
+    int key = static_cast<int>(rng() % 5000);
+    long value = static_cast<long>(rng() % 1000) - 500;
+    sums.insert_or_assign(key, value);
+    mins.insert_or_assign(key, value);
+    std_map[key] = value;
+  }
+  for (int i = 0; i < 1000; ++i) {
+    int key = static_cast<int>(rng() % 5000);
+    if (sums.contains(key)) {
+      sums.erase(sums.find(key));
+      mins.erase(mins.find(key));
+      std_map.erase(key);
+    }
+  }
+  ASSERT_TRUE(sums.is_balanced());
+  for (int query = 0; query < 500; ++query) {
+    int lo = static_cast<int>(rng() % 5200) - 100;
+    int hi = lo + static_cast<int>(rng() % 2000);
+    long sum = 0;
+    long low = std::numeric_limits<long>::max();
+    auto last = std_map.lower_bound(std::max(lo, hi));
+    for (auto it = std_map.lower_bound(lo); it != last; ++it) {
+      sum += it->second;
+      low = std::min(low, it->second);
+    }
+    EXPECT_EQ(sums.aggregate(lo, hi), sum);
+    EXPECT_EQ(mins.aggregate(lo, hi), low);
+  }
+  EXPECT_EQ(sums.aggregate(10, 10), 0);
+}
+
+TEST(map_test, aggregating_map_values_change_only_through_tree) {
+  using sum_map = s21::map<int, long, std::less<int>,
+                           std::allocator<std::pair<int, long>>,
+                           s21::range_sum<long>>;
+  sum_map sums{{1, 10}, {2, 20}, {3, 30}};
+  // запись по ссылке из operator[], at или итератора не компилируется
+  static_assert(!std::is_assignable_v<decltype(sums[1]), long>);
+  static_assert(!std::is_assignable_v<decltype(sums.at(1)), long>);
+  static_assert(!std::is_assignable_v<decltype(sums.begin()->second), long>);
+  EXPECT_EQ(sums[4], 0);
+  EXPECT_EQ(sums.aggregate(0, 10), 60);
+  EXPECT_TRUE(sums.update(4, [](long& value) { value = 40; }));
+  EXPECT_TRUE(sums.update(2, [](long& value) { value *= 3; }));
+  EXPECT_FALSE(sums.update(7, [](long& value) { value = 1; }));
+  EXPECT_EQ(sums[4], 40);
+  EXPECT_EQ(sums.aggregate(0, 10), 140);
+  EXPECT_EQ(sums.aggregate(2, 4), 90);
+  EXPECT_THROW(sums.update(1,
+                           [](long& value) {
+                             value = 100;
+                             throw std::runtime_error("update");
+                           }),
+               std::runtime_error);
+  EXPECT_EQ(sums.aggregate(0, 2), 100);
+  sums.insert_or_assign(3, 0L);
+  EXPECT_EQ(sums.aggregate(0, 10), 200);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "../s21_library/s21_multiset.h"
 
@@ -296,4 +299,291 @@ TEST(multiset_test, contains_method) {
   EXPECT_TRUE(s21_multiset.contains(5));
 
   EXPECT_FALSE(s21_multiset.contains(20));
-}
\ No newline at end of file
+}
+TEST(multiset_test_eq, range_constructor_keeps_duplicates) {
+  std::vector<int> keys = {1, 1, 2, 3, 3, 3, 4, 5, 5};
+  s21::multiset<int> s21_multiset(keys.begin(), keys.end());
+  std::multiset<int> std_multiset(keys.begin(), keys.end());
+
+  EXPECT_EQ(s21_multiset.size(), std_multiset.size());
+  EXPECT_TRUE(s21_multiset.is_balanced());
+  EXPECT_TRUE(containers_equal(s21_multiset.begin(), s21_multiset.end(),
+                               std_multiset.begin(), std_multiset.end()));
+}
+
+TEST(multiset_test_eq, assign_sorted_unsorted_input) {
+  std::vector<int> keys = {9, 4, 4, 7, 1, 9, 0, 4};
+  s21::multiset<int> s21_multiset = {100, 200};
+  s21_multiset.assign_sorted(keys.begin(), keys.end());
+  std::multiset<int> std_multiset(keys.begin(), keys.end());
+
+  EXPECT_EQ(s21_multiset.size(), std_multiset.size());
+  EXPECT_TRUE(s21_multiset.is_balanced());
+  EXPECT_TRUE(containers_equal(s21_multiset.begin(), s21_multiset.end(),
+                               std_multiset.begin(), std_multiset.end()));
+  s21_multiset.insert(4);
+  auto range = s21_multiset.equal_range(4);
+  int count = 0;
+  for (auto it = range.first; it != range.second; ++it) ++count;
+  EXPECT_EQ(count, 4);
+}
+
+TEST(multiset_test, emplace_keeps_duplicates) {
+  s21::multiset<std::string> s21_multiset;
+  std::string value = "echo";
+  s21_multiset.insert(std::move(value));
+  s21_multiset.emplace(3, 'a');
+  s21_multiset.emplace("echo");
+  auto it = s21_multiset.emplace_hint(s21_multiset.cbegin(), "aaa");
+
+  EXPECT_EQ(*it, "aaa");
+  EXPECT_EQ(s21_multiset.size(), 4U);
+  std::vector<std::string> expected = {"aaa", "aaa", "echo", "echo"};
+  EXPECT_TRUE(std::equal(s21_multiset.begin(), s21_multiset.end(),
+                         expected.begin(), expected.end()));
+}
+
+TEST(multiset_test_eq, hinted_insert_keeps_duplicates) {
+  s21::multiset<int> s21_multiset;
+  std::multiset<int> std_multiset;
+  for (int i = 0; i < 300; ++i) {
+    s21_multiset.insert(s21_multiset.cend(), i / 3);
+    s21_multiset.insert(s21_multiset.cbegin(), i % 7);
+    std_multiset.insert(i / 3);
+    std_multiset.insert(i % 7);
+  }
+  EXPECT_TRUE(s21_multiset.is_balanced());
+  EXPECT_EQ(s21_multiset.size(), std_multiset.size());
+  EXPECT_TRUE(std::equal(s21_multiset.begin(), s21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+}
+
+TEST(multiset_test_eq, reverse_iteration) {
+  s21::multiset<int> s21_multiset{3, 1, 3, 2, 1};
+  std::multiset<int> std_multiset{3, 1, 3, 2, 1};
+  EXPECT_TRUE(std::equal(s21_multiset.rbegin(), s21_multiset.rend(),
+                         std_multiset.rbegin(), std_multiset.rend()));
+}
+
+TEST(multiset_test, merge_moves_every_node) {
+  s21::multiset<int> s21_multiset{1, 2, 2};
+  s21::multiset<int> s21_multiset2{2, 3};
+  s21_multiset.merge(s21_multiset2);
+  EXPECT_TRUE(s21_multiset2.empty());
+
+  auto handle = s21_multiset.extract(2);
+  ASSERT_FALSE(handle.empty());
+  s21_multiset2.insert(std::move(handle));
+  EXPECT_EQ(s21_multiset.size(), 4U);
+  EXPECT_EQ(s21_multiset2.size(), 1U);
+  EXPECT_TRUE(s21_multiset.extract(7).empty());
+}
+
+TEST(multiset_test, order_statistics_for_percentiles) {
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::subtree_size>
+      latencies;
+  std::vector<int> sorted;
+  for (int i = 0; i < 1000; ++i) {
+    int value = (i * 37) % 200;
+    latencies.insert(value);
+    sorted.push_back(value);
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  EXPECT_EQ(*latencies.nth(0), sorted.front());
+  EXPECT_EQ(*latencies.nth(989), sorted[989]);
+  EXPECT_TRUE(latencies.nth(1000) == latencies.end());
+  EXPECT_EQ(latencies.rank(100), 500U);
+  EXPECT_EQ(latencies.count_range(10, 20), 50U);
+  EXPECT_EQ(latencies.count_range(20, 10), 0U);
+
+  latencies.erase(latencies.nth(0));
+  EXPECT_EQ(latencies.rank(1), 4U);
+}
+
+TEST(multiset_test, split_and_join_duplicates) {
+  s21::multiset<int> s21_multiset{1, 2, 2, 2, 3, 3, 4};
+  auto parts = s21_multiset.split(3);
+  EXPECT_EQ(parts.first.size(), 4U);
+  EXPECT_EQ(parts.second.size(), 3U);
+  auto threes = parts.second.equal_range(3);
+  EXPECT_EQ(std::distance(threes.first, threes.second), 2);
+
+  auto joined = s21::multiset<int>::join(std::move(parts.first), 3,
+                                         std::move(parts.second));
+  EXPECT_EQ(joined.size(), 8U);
+  threes = joined.equal_range(3);
+  EXPECT_EQ(std::distance(threes.first, threes.second), 3);
+  EXPECT_TRUE(joined.is_balanced());
+}
+
+TEST(multiset_test, set_operations_keep_multiplicity) {
+  auto united = s21::multiset<int>::set_union(
+      s21::multiset<int>{1, 1, 2, 3, 3, 3}, s21::multiset<int>{1, 3, 3, 4, 4});
+  std::vector<int> expected{1, 1, 2, 3, 3, 3, 4, 4};
+  EXPECT_TRUE(std::equal(united.begin(), united.end(), expected.begin(),
+                         expected.end()));
+
+  auto common = s21::multiset<int>::set_intersection(
+      s21::multiset<int>{1, 1, 2, 3, 3, 3}, s21::multiset<int>{1, 3, 3, 4, 4});
+  expected = {1, 3, 3};
+  EXPECT_TRUE(std::equal(common.begin(), common.end(), expected.begin(),
+                         expected.end()));
+
+  auto rest = s21::multiset<int>::set_difference(
+      s21::multiset<int>{1, 1, 2, 3, 3, 3}, s21::multiset<int>{1, 3, 3, 4, 4});
+  expected = {1, 2, 3};
+  EXPECT_TRUE(std::equal(rest.begin(), rest.end(), expected.begin(),
+                         expected.end()));
+  EXPECT_TRUE(rest.is_balanced());
+}
+
+TEST(multiset_test, b_tree_nodes_keep_duplicates) {
+  s21::multiset<int, std::less<int>, std::allocator<int>,
+                s21::b_tree_nodes<4>>
+      s21_multiset;
+  std::multiset<int> std_multiset;
+  for (int i = 0; i < 1500; ++i) {
+    s21_multiset.insert(i % 37);
+    std_multiset.insert(i % 37);
+  }
+  for (int i = 0; i < 400; ++i) {
+    s21_multiset.erase(s21_multiset.find(i % 11));
+    std_multiset.erase(std_multiset.find(i % 11));
+  }
+  EXPECT_TRUE(std::equal(s21_multiset.begin(), s21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+  auto range = s21_multiset.equal_range(20);
+  EXPECT_EQ(std::distance(range.first, range.second),
+            static_cast<std::ptrdiff_t>(std_multiset.count(20)));
+  EXPECT_EQ(*s21_multiset.begin(), *std_multiset.begin());
+  size_t visited = 0;
+  s21_multiset.for_each_in_range(20, 22, [&visited](int) { ++visited; });
+  EXPECT_EQ(visited, std_multiset.count(20) + std_multiset.count(21));
+}
+
+TEST(multiset_test, erase_range_between_duplicates) {
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::subtree_size>
+      s21_multiset;
+  std::multiset<int> std_multiset;
+  for (int i = 0; i < 2000; ++i) {
+    s21_multiset.insert(i % 50);
+    std_multiset.insert(i % 50);
+  }
+  // границы стоят посреди серий равных ключей
+  for (int step = 0; step < 30; ++step) {
+    size_t from = (step * 131) % s21_multiset.size();
+    size_t count = (step * 17) % 90;
+    if (from + count > s21_multiset.size()) count = s21_multiset.size() - from;
+    auto first = s21_multiset.nth(from);
+    auto last = s21_multiset.nth(from + count);
+    auto next = s21_multiset.erase(first, last);
+    auto std_first = std::next(std_multiset.begin(), from);
+    std_multiset.erase(std_first, std::next(std_first, count));
+    EXPECT_TRUE(next == s21_multiset.nth(from));
+    ASSERT_TRUE(s21_multiset.is_balanced());
+    ASSERT_EQ(s21_multiset.size(), std_multiset.size());
+    EXPECT_EQ(s21_multiset.rank(25), static_cast<size_t>(std::distance(
+                                         std_multiset.begin(),
+                                         std_multiset.lower_bound(25))));
+  }
+  EXPECT_TRUE(std::equal(s21_multiset.begin(), s21_multiset.end(),
+                         std_multiset.begin(), std_multiset.end()));
+  auto range = s21_multiset.equal_range(7);
+  s21_multiset.erase(range.first, range.second);
+  EXPECT_FALSE(s21_multiset.contains(7));
+  s21_multiset.erase(s21_multiset.begin(), s21_multiset.end());
+  EXPECT_TRUE(s21_multiset.empty());
+}
+
+TEST(multiset_test, bounds_and_range_visit) {
+  s21::multiset<int> s21_multiset = {1, 3, 3, 3, 5, 7, 7, 9};
+  const auto& view = s21_multiset;
+  EXPECT_EQ(std::distance(view.cbegin(), view.lower_bound(3)), 1);
+  EXPECT_EQ(std::distance(view.cbegin(), view.upper_bound(3)), 4);
+  auto range = view.equal_range(7);
+  EXPECT_EQ(std::distance(range.first, range.second), 2);
+  EXPECT_TRUE(view.lower_bound(10) == view.cend());
+  EXPECT_EQ(view.count(3), 3U);
+  EXPECT_EQ(view.count(4), 0U);
+  std::vector<int> visited;
+  view.for_each_in_range(3, 8, [&visited](int x) { visited.push_back(x); });
+  EXPECT_EQ(visited, (std::vector<int>{3, 3, 3, 5, 7, 7}));
+}
+
+TEST(multiset_test, counted_nodes_histogram) {
+  using counted_multiset =
+      s21::multiset<int, std::less<int>, std::allocator<int>,
+                    s21::counted_nodes>;
+  counted_multiset histogram;
+  std::multiset<int> std_multiset;
+  for (int i = 0; i < 20000; ++i) {
+    histogram.insert(i % 13);
+    std_multiset.insert(i % 13);
+  }
+  EXPECT_EQ(histogram.size(), std_multiset.size());
+  EXPECT_EQ(histogram.distinct_count(), 13U);
+  EXPECT_EQ(histogram.count(5), std_multiset.count(5));
+  EXPECT_EQ(histogram.count(13), 0U);
+  EXPECT_TRUE(std::equal(histogram.begin(), histogram.end(),
+                         std_multiset.begin(), std_multiset.end()));
+  EXPECT_TRUE(std::equal(histogram.rbegin(), histogram.rend(),
+                         std_multiset.rbegin(), std_multiset.rend()));
+
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(histogram.erase_one(i % 3));
+    std_multiset.erase(std_multiset.find(i % 3));
+  }
+  EXPECT_EQ(histogram.erase(7), std_multiset.erase(7));
+  EXPECT_FALSE(histogram.erase_one(7));
+  histogram.insert(12, 5);
+  std_multiset.insert({12, 12, 12, 12, 12});
+  auto range = histogram.equal_range(4);
+  EXPECT_EQ(std::distance(range.first, range.second),
+            static_cast<std::ptrdiff_t>(std_multiset.count(4)));
+  EXPECT_EQ(histogram.size(), std_multiset.size());
+  EXPECT_TRUE(std::equal(histogram.begin(), histogram.end(),
+                         std_multiset.begin(), std_multiset.end()));
+}
+
+TEST(multiset_test, counted_nodes_erase_by_iterator) {
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::counted_nodes>
+      counted = {1, 2, 2, 2, 3};
+  auto it = counted.find(2);
+  ++it;
+  it = counted.erase(it);
+  EXPECT_EQ(*it, 2);
+  it = counted.erase(it);
+  EXPECT_EQ(*it, 3);
+  EXPECT_EQ(counted.count(2), 1U);
+  it = counted.erase(counted.find(2));
+  EXPECT_EQ(*it, 3);
+  EXPECT_FALSE(counted.contains(2));
+  EXPECT_EQ(counted.size(), 2U);
+
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::counted_nodes>
+      other = {3, 3, 4};
+  counted.merge(other);
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(counted.count(3), 3U);
+  std::vector<std::pair<int, size_t>> runs;
+  counted.for_each_run(
+      [&runs](int key, size_t count) { runs.emplace_back(key, count); });
+  EXPECT_EQ(runs, (std::vector<std::pair<int, size_t>>{{1, 1}, {3, 3},
+                                                        {4, 1}}));
+}
+
+TEST(multiset_test, parallel_copy_keeps_subtree_sizes) {
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::subtree_size>
+      source;
+  for (int i = 0; i < 5000; ++i) source.insert(i % 700);
+  s21::parallel_options options;
+  options.threads = 8;
+  options.sequential_cutoff = 8;
+  s21::multiset<int, std::less<int>, std::allocator<int>, s21::subtree_size>
+      copy(source, options);
+  EXPECT_TRUE(std::equal(copy.cbegin(), copy.cend(), source.cbegin(),
+                         source.cend()));
+  EXPECT_EQ(copy.rank(350), source.rank(350));
+  EXPECT_EQ(*copy.nth(4321), *source.nth(4321));
+}
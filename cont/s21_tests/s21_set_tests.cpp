@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <numeric>
 #include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "../s21_library/s21_set.h"
 
@@ -301,4 +312,734 @@ TEST(set_test, single_element_insert) {
   EXPECT_EQ(s21_set.size(), 1U);
 
   EXPECT_TRUE(results[0].second);
-}
\ No newline at end of file
+}
+struct allocation_counter {
+  static inline size_t allocations = 0;
+  static inline size_t deallocations = 0;
+};
+
+template <typename T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() = default;
+  template <typename U>
+  counting_allocator(const counting_allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    ++allocation_counter::allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *ptr, size_t n) {
+    ++allocation_counter::deallocations;
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  bool operator==(const counting_allocator &) const { return true; }
+  bool operator!=(const counting_allocator &) const { return false; }
+};
+
+TEST(set_test, pool_allocates_nodes_in_slabs) {
+  allocation_counter::allocations = allocation_counter::deallocations = 0;
+  {
+    s21::set<int, std::less<int>, counting_allocator<int>> s21_set;
+    for (int i = 0; i < 10000; ++i) {
+      s21_set.insert(i);
+    }
+    EXPECT_EQ(s21_set.size(), 10000U);
+    EXPECT_LT(allocation_counter::allocations, 20U);
+    EXPECT_TRUE(s21_set.is_balanced());
+  }
+  EXPECT_EQ(allocation_counter::allocations,
+            allocation_counter::deallocations);
+}
+
+TEST(set_test, pool_reuses_erased_nodes) {
+  s21::set<int, std::less<int>, counting_allocator<int>> s21_set;
+  for (int i = 0; i < 1000; ++i) {
+    s21_set.insert(i);
+  }
+  size_t allocations = allocation_counter::allocations;
+  for (int i = 0; i < 1000; i += 2) {
+    s21_set.erase(s21_set.find(i));
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    s21_set.insert(i + 1000);
+  }
+  EXPECT_EQ(s21_set.size(), 1000U);
+  EXPECT_EQ(allocation_counter::allocations, allocations);
+  EXPECT_TRUE(s21_set.is_balanced());
+}
+
+TEST(set_test, pool_releases_slabs_on_clear) {
+  s21::set<int, std::less<int>, counting_allocator<int>> s21_set;
+  size_t deallocations = allocation_counter::deallocations;
+  for (int i = 0; i < 1000; ++i) {
+    s21_set.insert(i);
+  }
+  size_t allocated = allocation_counter::allocations;
+  s21_set.clear();
+  EXPECT_TRUE(s21_set.empty());
+  EXPECT_GT(allocation_counter::deallocations, deallocations);
+
+  s21_set.insert(42);
+  EXPECT_TRUE(s21_set.contains(42));
+  EXPECT_GT(allocation_counter::allocations, allocated);
+}
+
+template <typename T>
+struct per_node_counting_allocator : counting_allocator<T> {
+  per_node_counting_allocator() = default;
+  template <typename U>
+  per_node_counting_allocator(const per_node_counting_allocator<U> &) {}
+};
+
+namespace s21 {
+template <typename T>
+struct per_node_allocation<per_node_counting_allocator<T>> : std::true_type {};
+}  // namespace s21
+
+TEST(set_test, per_node_allocation_bypasses_slabs) {
+  allocation_counter::allocations = allocation_counter::deallocations = 0;
+  {
+    s21::set<int, std::less<int>, per_node_counting_allocator<int>> s21_set;
+    s21_set.insert(0);
+    size_t allocations = allocation_counter::allocations;
+    for (int i = 1; i < 1000; ++i) s21_set.insert(i);
+    EXPECT_EQ(allocation_counter::allocations - allocations, 999U);
+    size_t deallocations = allocation_counter::deallocations;
+    for (int i = 0; i < 1000; i += 2) s21_set.erase(s21_set.find(i));
+    EXPECT_EQ(allocation_counter::deallocations - deallocations, 500U);
+    s21::set<int, std::less<int>, per_node_counting_allocator<int>> copy(
+        s21_set);
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), s21_set.begin(),
+                           s21_set.end()));
+    s21_set.clear();
+    EXPECT_TRUE(s21_set.empty());
+    EXPECT_TRUE(s21_set.is_balanced());
+  }
+  EXPECT_EQ(allocation_counter::allocations,
+            allocation_counter::deallocations);
+}
+
+struct allocation_failure {
+  // сколько выделений пройдёт до отказа; -1 — отказов нет
+  static inline int countdown = -1;
+  static inline size_t live = 0;
+};
+
+template <typename T>
+struct failing_allocator {
+  using value_type = T;
+
+  failing_allocator() = default;
+  template <typename U>
+  failing_allocator(const failing_allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    if (allocation_failure::countdown == 0) throw std::bad_alloc();
+    if (allocation_failure::countdown > 0) --allocation_failure::countdown;
+    ++allocation_failure::live;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *ptr, size_t n) {
+    --allocation_failure::live;
+    std::allocator<T>().deallocate(ptr, n);
+  }
+
+  bool operator==(const failing_allocator &) const { return true; }
+  bool operator!=(const failing_allocator &) const { return false; }
+};
+
+TEST(set_test, b_tree_insert_survives_allocation_failure) {
+  using failing_set = s21::set<int, std::less<int>, failing_allocator<int>,
+                               s21::b_tree_nodes<4>>;
+  allocation_failure::live = 0;
+  {
+    failing_set s21_set;
+    std::set<int> std_set;
+    size_t failures = 0;
+    for (int i = 0; i < 600; ++i) {
+      int key = (i * 7919) % 1013;
+      // отказ на первом, втором или третьем выделении вставки попадает в
+      // лист, в полного предка и в новый корень
+      allocation_failure::countdown = i % 3;
+      bool inserted;
+      try {
+        inserted = s21_set.insert(key).second;
+      } catch (const std::bad_alloc &) {
+        ++failures;
+        EXPECT_EQ(s21_set.size(), std_set.size());
+        EXPECT_FALSE(s21_set.contains(key));
+        allocation_failure::countdown = -1;
+        inserted = s21_set.insert(key).second;
+      }
+      allocation_failure::countdown = -1;
+      EXPECT_EQ(inserted, std_set.insert(key).second);
+    }
+    EXPECT_GT(failures, 0U);
+    EXPECT_EQ(s21_set.size(), std_set.size());
+    EXPECT_TRUE(containers_equal(s21_set.begin(), s21_set.end(),
+                                 std_set.begin(), std_set.end()));
+    for (int key = 0; key < 1013; ++key) {
+      EXPECT_EQ(s21_set.contains(key), std_set.count(key) == 1);
+    }
+
+    std::vector<int> sorted(100);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    allocation_failure::countdown = 20;
+    EXPECT_THROW(failing_set(sorted.begin(), sorted.end()), std::bad_alloc);
+    allocation_failure::countdown = -1;
+  }
+  EXPECT_EQ(allocation_failure::live, 0U);
+}
+
+struct tracked_value {
+  static inline int alive = 0;
+  int value;
+
+  tracked_value(int v = 0) : value(v) { ++alive; }
+  tracked_value(const tracked_value &other) : value(other.value) { ++alive; }
+  ~tracked_value() { --alive; }
+  tracked_value &operator=(const tracked_value &other) = default;
+  bool operator<(const tracked_value &other) const {
+    return value < other.value;
+  }
+};
+
+TEST(set_test, clear_destroys_every_element) {
+  tracked_value::alive = 0;
+  s21::set<tracked_value> s21_set;
+  for (int i = 0; i < 1000; ++i) {
+    s21_set.insert(tracked_value(i * 7 % 1000));
+  }
+  EXPECT_EQ(tracked_value::alive, 1000);
+  s21_set.clear();
+  EXPECT_EQ(tracked_value::alive, 0);
+  EXPECT_TRUE(s21_set.empty());
+  EXPECT_TRUE(s21_set.begin() == s21_set.end());
+
+  s21_set.insert(tracked_value(5));
+  EXPECT_TRUE(s21_set.contains(tracked_value(5)));
+  EXPECT_EQ(tracked_value::alive, 1);
+}
+
+TEST(set_test, move_assignment_destroys_previous_elements) {
+  tracked_value::alive = 0;
+  {
+    s21::set<tracked_value> s21_set;
+    s21::set<tracked_value> s21_set2;
+    for (int i = 0; i < 100; ++i) {
+      s21_set.insert(tracked_value(i));
+      s21_set2.insert(tracked_value(i + 100));
+    }
+    s21_set = std::move(s21_set2);
+    EXPECT_EQ(tracked_value::alive, 100);
+    EXPECT_EQ(s21_set.size(), 100U);
+    EXPECT_TRUE(s21_set.contains(tracked_value(150)));
+  }
+  EXPECT_EQ(tracked_value::alive, 0);
+}
+
+TEST(set_test_eq, range_constructor_sorted) {
+  std::vector<int> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.push_back(i * 3);
+  }
+  s21::set<int> s21_set(keys.begin(), keys.end());
+  std::set<int> std_set(keys.begin(), keys.end());
+
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(s21_set.is_balanced());
+  EXPECT_TRUE(containers_equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                               std_set.end()));
+  EXPECT_TRUE(s21_set.contains(2997));
+  EXPECT_FALSE(s21_set.contains(2998));
+}
+
+TEST(set_test_eq, range_constructor_unsorted_with_duplicates) {
+  std::vector<int> keys = {5, 3, 9, 3, 1, 5, 7, 7, 0, 2};
+  s21::set<int> s21_set(keys.begin(), keys.end());
+  std::set<int> std_set(keys.begin(), keys.end());
+
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(s21_set.is_balanced());
+  EXPECT_TRUE(containers_equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                               std_set.end()));
+}
+
+TEST(set_test_eq, assign_sorted_replaces_contents) {
+  s21::set<int> s21_set({100, 200, 300});
+  for (int count = 0; count < 70; ++count) {
+    std::vector<int> keys;
+    for (int i = 0; i < count; ++i) {
+      keys.push_back(i);
+      keys.push_back(i);
+    }
+    s21_set.assign_sorted(keys.begin(), keys.end());
+    std::set<int> std_set(keys.begin(), keys.end());
+
+    EXPECT_EQ(s21_set.size(), std_set.size());
+    EXPECT_TRUE(s21_set.is_balanced());
+    EXPECT_TRUE(containers_equal(s21_set.begin(), s21_set.end(),
+                                 std_set.begin(), std_set.end()));
+  }
+  s21_set.insert(-1);
+  s21_set.erase(s21_set.find(10));
+  EXPECT_TRUE(s21_set.is_balanced());
+  EXPECT_EQ(s21_set.size(), 69U);
+}
+
+TEST(set_test_eq, range_constructor_from_input_iterator) {
+  std::istringstream input("4 1 3 1 2");
+  s21::set<int> s21_set(std::istream_iterator<int>(input),
+                        std::istream_iterator<int>{});
+  std::set<int> std_set({1, 2, 3, 4});
+
+  EXPECT_TRUE(containers_equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                               std_set.end()));
+}
+
+TEST(set_test, emplace_constructs_in_place) {
+  s21::set<std::pair<int, std::string>> s21_set;
+  auto first = s21_set.emplace(2, "two");
+  auto second = s21_set.emplace(2, "two");
+  s21_set.insert(std::make_pair(1, std::string("one")));
+
+  EXPECT_TRUE(first.second);
+  EXPECT_FALSE(second.second);
+  EXPECT_TRUE(first.first == second.first);
+  EXPECT_EQ(s21_set.size(), 2U);
+  EXPECT_EQ(s21_set.begin()->second, "one");
+}
+
+TEST(set_test_eq, hinted_insert_monotonic_keys) {
+  s21::set<int> ascending;
+  s21::set<int> descending;
+  std::set<int> std_set;
+  for (int i = 0; i < 1000; ++i) {
+    ascending.insert(ascending.cend(), i);
+    descending.insert(descending.cbegin(), 999 - i);
+    std_set.insert(i);
+  }
+  auto it = ascending.insert(ascending.cend(), 500);
+  EXPECT_EQ(*it, 500);
+
+  EXPECT_TRUE(ascending.is_balanced());
+  EXPECT_TRUE(descending.is_balanced());
+  EXPECT_EQ(ascending.size(), std_set.size());
+  EXPECT_TRUE(std::equal(ascending.begin(), ascending.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(std::equal(descending.begin(), descending.end(),
+                         std_set.begin(), std_set.end()));
+}
+
+TEST(set_test_eq, hinted_insert_with_wrong_hint) {
+  s21::set<int> s21_set{10, 20, 30, 40};
+  std::set<int> std_set{10, 20, 30, 40, 5, 35, 25};
+  s21_set.insert(s21_set.find(40), 5);
+  s21_set.insert(s21_set.cbegin(), 35);
+  s21_set.insert(s21_set.find(20), 25);
+
+  s21::set<int> copy(s21_set);
+  EXPECT_TRUE(copy.is_balanced());
+  EXPECT_TRUE(std::equal(copy.begin(), copy.end(), std_set.begin(),
+                         std_set.end()));
+}
+
+TEST(set_test_eq, reverse_iteration) {
+  s21::set<int> s21_set{5, 1, 4, 2, 3};
+  std::set<int> std_set{5, 1, 4, 2, 3};
+
+  EXPECT_EQ(*--s21_set.end(), 5);
+  EXPECT_TRUE(std::equal(s21_set.rbegin(), s21_set.rend(), std_set.rbegin(),
+                         std_set.rend()));
+  EXPECT_TRUE(std::equal(s21_set.crbegin(), s21_set.crend(),
+                         std_set.crbegin(), std_set.crend()));
+
+  s21::set<int> empty;
+  EXPECT_TRUE(empty.begin() == empty.end());
+  EXPECT_TRUE(empty.rbegin() == empty.rend());
+}
+
+TEST(set_test, end_is_reachable_after_erase) {
+  s21::set<int> s21_set{1, 2, 3};
+  s21_set.erase(s21_set.find(3));
+  auto last = --s21_set.end();
+  EXPECT_EQ(*last, 2);
+  EXPECT_TRUE(++last == s21_set.end());
+  s21_set.erase(s21_set.begin());
+  s21_set.erase(s21_set.begin());
+  EXPECT_TRUE(s21_set.begin() == s21_set.end());
+}
+
+TEST(set_test, merge_relinks_nodes_without_allocation) {
+  using counted_set = s21::set<int, std::less<int>, counting_allocator<int>>;
+  counted_set s21_set{1, 3, 5};
+  size_t allocations = 0;
+  {
+    counted_set s21_set2{2, 3, 4};
+    allocations = allocation_counter::allocations;
+    s21_set.merge(s21_set2);
+    EXPECT_EQ(allocation_counter::allocations, allocations);
+    EXPECT_EQ(s21_set2.size(), 1U);
+    EXPECT_TRUE(s21_set2.contains(3));
+  }
+  std::vector<int> expected = {1, 2, 3, 4, 5};
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), expected.begin(),
+                         expected.end()));
+  EXPECT_TRUE(s21_set.is_balanced());
+}
+
+TEST(set_test, extract_and_insert_node) {
+  s21::set<int> s21_set{1, 2, 3};
+  s21::set<int> s21_set2{3};
+
+  auto handle = s21_set.extract(2);
+  ASSERT_FALSE(handle.empty());
+  EXPECT_EQ(handle.value(), 2);
+  EXPECT_EQ(s21_set.size(), 2U);
+  EXPECT_TRUE(s21_set.extract(42).empty());
+
+  auto result = s21_set2.insert(std::move(handle));
+  EXPECT_TRUE(result.inserted);
+  EXPECT_EQ(*result.position, 2);
+  EXPECT_TRUE(result.node.empty());
+
+  result = s21_set2.insert(s21_set.extract(s21_set.find(3)));
+  EXPECT_FALSE(result.inserted);
+  ASSERT_FALSE(result.node.empty());
+  EXPECT_EQ(result.node.value(), 3);
+  EXPECT_EQ(*result.position, 3);
+
+  s21_set.clear();
+  EXPECT_EQ(s21_set2.size(), 2U);
+  EXPECT_TRUE(s21_set2.contains(2));
+}
+
+TEST(set_test, order_statistics_after_erase) {
+  s21::set<int, std::less<int>, std::allocator<int>, s21::subtree_size>
+      s21_set;
+  for (int i = 0; i < 100; ++i) {
+    s21_set.insert(s21_set.cend(), i * 10);
+  }
+  for (int i = 0; i < 100; i += 2) {
+    s21_set.erase(s21_set.find(i * 10));
+  }
+  EXPECT_EQ(*s21_set.nth(0), 10);
+  EXPECT_EQ(*s21_set.nth(49), 990);
+  EXPECT_EQ(s21_set.rank(500), 25U);
+  EXPECT_EQ(s21_set.count_range(0, 1000), 50U);
+
+  auto copy = s21_set;
+  EXPECT_EQ(*copy.nth(25), 510);
+}
+
+TEST(set_test, split_and_join) {
+  s21::set<int> s21_set;
+  for (int i = 0; i < 1000; ++i) {
+    s21_set.insert(s21_set.cend(), i);
+  }
+  auto parts = s21_set.split(300);
+  EXPECT_TRUE(s21_set.empty());
+  EXPECT_EQ(parts.first.size(), 300U);
+  EXPECT_EQ(parts.second.size(), 700U);
+  EXPECT_EQ(*parts.first.rbegin(), 299);
+  EXPECT_EQ(*parts.second.begin(), 300);
+  EXPECT_TRUE(parts.first.is_balanced());
+  EXPECT_TRUE(parts.second.is_balanced());
+
+  auto joined = s21::set<int>::join(std::move(parts.first),
+                                    std::move(parts.second));
+  EXPECT_TRUE(parts.first.empty());
+  EXPECT_TRUE(parts.second.empty());
+  EXPECT_EQ(joined.size(), 1000U);
+  EXPECT_TRUE(joined.is_balanced());
+  int expected = 0;
+  for (auto it = joined.begin(); it != joined.end(); ++it) {
+    EXPECT_EQ(*it, expected++);
+  }
+  EXPECT_EQ(expected, 1000);
+}
+
+TEST(set_test, join_with_pivot) {
+  s21::set<int> left{1, 2, 3};
+  s21::set<int> right{10, 20, 30, 40, 50, 60, 70, 80, 90};
+  auto joined = s21::set<int>::join(std::move(left), 5, std::move(right));
+  EXPECT_EQ(joined.size(), 13U);
+  EXPECT_TRUE(joined.contains(5));
+  EXPECT_TRUE(joined.is_balanced());
+
+  s21::set<int> low{1, 2};
+  s21::set<int> high{2, 3};
+  EXPECT_THROW(s21::set<int>::join(std::move(low), std::move(high)),
+               std::invalid_argument);
+  EXPECT_EQ(low.size(), 2U);
+  EXPECT_EQ(high.size(), 2U);
+}
+
+TEST(set_test, split_keeps_subtree_sizes) {
+  s21::set<int, std::less<int>, std::allocator<int>, s21::subtree_size>
+      s21_set;
+  for (int i = 0; i < 500; ++i) {
+    s21_set.insert(i * 2);
+  }
+  auto parts = s21_set.split(401);
+  EXPECT_EQ(parts.first.size(), 201U);
+  EXPECT_EQ(parts.second.size(), 299U);
+  EXPECT_EQ(*parts.second.nth(0), 402);
+  EXPECT_EQ(parts.first.rank(200), 100U);
+}
+
+TEST(set_test, set_operations) {
+  std::vector<int> evens;
+  std::vector<int> thirds;
+  for (int i = 0; i < 3000; i += 2) evens.push_back(i);
+  for (int i = 0; i < 3000; i += 3) thirds.push_back(i);
+  s21::parallel_options options;
+  options.threads = 4;
+  options.sequential_cutoff = 16;
+
+  auto united = s21::set<int>::set_union(
+      s21::set<int>(evens.begin(), evens.end()),
+      s21::set<int>(thirds.begin(), thirds.end()), options);
+  std::vector<int> expected;
+  std::set_union(evens.begin(), evens.end(), thirds.begin(), thirds.end(),
+                 std::back_inserter(expected));
+  EXPECT_TRUE(containers_equal(united.begin(), united.end(), expected.begin(),
+                               expected.end()));
+  EXPECT_TRUE(united.is_balanced());
+
+  auto common = s21::set<int>::set_intersection(
+      s21::set<int>(evens.begin(), evens.end()),
+      s21::set<int>(thirds.begin(), thirds.end()), options);
+  EXPECT_EQ(common.size(), 500U);
+  EXPECT_TRUE(common.contains(2994));
+  EXPECT_FALSE(common.contains(4));
+
+  s21::set<int> left(evens.begin(), evens.end());
+  auto rest = s21::set<int>::set_difference(
+      std::move(left), s21::set<int>(thirds.begin(), thirds.end()));
+  EXPECT_TRUE(left.empty());
+  EXPECT_EQ(rest.size(), 1000U);
+  EXPECT_TRUE(rest.contains(4));
+  EXPECT_FALSE(rest.contains(6));
+  EXPECT_TRUE(rest.is_balanced());
+}
+
+template <typename tree_type>
+struct node_size_probe : tree_type {
+  static constexpr size_t value = sizeof(typename tree_type::node);
+};
+
+TEST(set_test, compact_node_layout) {
+  // данные, два потомка и родитель с цветом в младшем бите
+  EXPECT_EQ(node_size_probe<s21::set<int>>::value, 4 * sizeof(void *));
+  EXPECT_EQ(node_size_probe<s21::set<uint64_t>>::value, 4 * sizeof(void *));
+}
+
+using btree_set = s21::set<int, std::less<int>, std::allocator<int>,
+                           s21::b_tree_nodes<4>>;
+
+TEST(set_test, b_tree_nodes_match_std) {
+  btree_set s21_set;
+  std::set<int> std_set;
+  for (int i = 0; i < 2000; ++i) {
+    int key = (i * 7919) % 1013;
+    EXPECT_EQ(s21_set.insert(key).second, std_set.insert(key).second);
+  }
+  for (int key = 0; key < 1013; key += 3) {
+    s21_set.erase(s21_set.find(key));
+    std_set.erase(key);
+  }
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(containers_equal(s21_set.begin(), s21_set.end(),
+                               std_set.begin(), std_set.end()));
+  EXPECT_TRUE(std::equal(s21_set.rbegin(), s21_set.rend(), std_set.rbegin(),
+                         std_set.rend()));
+  EXPECT_EQ(*s21_set.lower_bound(300), *std_set.lower_bound(300));
+  EXPECT_EQ(*s21_set.upper_bound(301), *std_set.upper_bound(301));
+  EXPECT_FALSE(s21_set.contains(999));
+  EXPECT_TRUE(s21_set.contains(1000));
+}
+
+TEST(set_test, b_tree_nodes_copy_and_merge) {
+  std::vector<int> sorted(3000);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  btree_set s21_set(sorted.begin(), sorted.end());
+  btree_set copy(s21_set);
+  btree_set other{-1, 5, 3000};
+  copy.merge(other);
+  EXPECT_EQ(copy.size(), 3002U);
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_EQ(*other.begin(), 5);
+  EXPECT_EQ(*copy.begin(), -1);
+  EXPECT_EQ(s21_set.size(), 3000U);
+  s21_set.clear();
+  EXPECT_TRUE(s21_set.empty());
+  EXPECT_EQ(s21_set.begin(), s21_set.end());
+}
+
+TEST(set_test, find_batch_matches_find) {
+  s21::set<int> s21_set;
+  for (int i = 0; i < 1000; i += 3) s21_set.insert(i);
+  // 21 ключ — неполная последняя группа спусков
+  std::vector<int> keys;
+  for (int i = -5; i < 1000; i += 47) keys.push_back(i);
+  std::vector<s21::set<int>::iterator> found;
+  s21_set.find_batch(keys.begin(), keys.end(), std::back_inserter(found));
+  std::vector<bool> contained(keys.size());
+  s21_set.contains_batch(keys.begin(), keys.end(), contained.begin());
+  ASSERT_EQ(found.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(found[i], s21_set.find(keys[i]));
+    EXPECT_EQ(contained[i], s21_set.contains(keys[i]));
+  }
+  s21::set<int> empty;
+  std::vector<bool> none(2, true);
+  empty.contains_batch(keys.begin(), keys.begin() + 2, none.begin());
+  EXPECT_EQ(none, std::vector<bool>(2, false));
+}
+
+TEST(set_test, erase_range_and_range_visit) {
+  s21::set<int> s21_set;
+  std::set<int> std_set;
+  for (int i = 0; i < 3000; ++i) {
+    s21_set.insert((i * 7919) % 3000);
+    std_set.insert((i * 7919) % 3000);
+  }
+  for (int lo = 0; lo < 3000; lo += 370) {
+    auto next = s21_set.erase(s21_set.lower_bound(lo),
+                              s21_set.lower_bound(lo + 100));
+    std_set.erase(std_set.lower_bound(lo), std_set.lower_bound(lo + 100));
+    EXPECT_TRUE(next == s21_set.lower_bound(lo + 100));
+    ASSERT_TRUE(s21_set.is_balanced());
+  }
+  ASSERT_EQ(s21_set.size(), std_set.size());
+  EXPECT_TRUE(std::equal(s21_set.begin(), s21_set.end(), std_set.begin(),
+                         std_set.end()));
+  EXPECT_TRUE(s21_set.erase(s21_set.begin(), s21_set.begin()) ==
+              s21_set.begin());
+
+  std::vector<int> visited;
+  s21_set.for_each_in_range(350, 900,
+                            [&visited](int x) { visited.push_back(x); });
+  std::vector<int> expected(std_set.lower_bound(350),
+                            std_set.lower_bound(900));
+  EXPECT_EQ(visited, expected);
+  visited.clear();
+  s21_set.for_each_in_range(900, 350,
+                            [&visited](int x) { visited.push_back(x); });
+  EXPECT_TRUE(visited.empty());
+}
+
+TEST(set_test, range_max_over_keys) {
+  s21::set<int, std::less<int>, std::allocator<int>, s21::range_max<int>>
+      s21_set = {5, 1, 9, 3, 7};
+  EXPECT_EQ(s21_set.aggregate(0, 100), 9);
+  EXPECT_EQ(s21_set.aggregate(2, 7), 5);
+  EXPECT_EQ(s21_set.aggregate(6, 7), std::numeric_limits<int>::lowest());
+  s21_set.erase(s21_set.find(9));
+  s21_set.insert(8);
+  EXPECT_EQ(s21_set.aggregate(0, 100), 8);
+}
+
+TEST(set_test, parallel_copy_matches_source) {
+  s21::set<int> source;
+  for (int i = 0; i < 20000; ++i) source.insert((i * 7919) % 20000);
+  s21::parallel_options options;
+  options.threads = 4;
+  options.sequential_cutoff = 16;
+  options.fork_depth = 3;
+  s21::set<int> copy(source, options);
+  ASSERT_EQ(copy.size(), source.size());
+  EXPECT_TRUE(copy.is_balanced());
+  EXPECT_TRUE(std::equal(copy.cbegin(), copy.cend(), source.cbegin(),
+                         source.cend()));
+  // копия независима и пишет в объединённый пул потоков
+  for (int i = 0; i < 20000; i += 2) copy.erase(copy.find(i));
+  for (int i = 20000; i < 21000; ++i) copy.insert(i);
+  EXPECT_EQ(source.size(), 20000U);
+  EXPECT_EQ(copy.size(), 11000U);
+  EXPECT_TRUE(copy.is_balanced());
+  s21::set<int> empty_copy(s21::set<int>(), options);
+  EXPECT_TRUE(empty_copy.empty());
+}
+
+TEST(set_test, parallel_copy_without_cutoff) {
+  s21::set<int> source;
+  for (int i = 0; i < 10; ++i) source.insert(i);
+  s21::parallel_options options;
+  options.threads = 1024;
+  options.fork_depth = 64;
+  options.sequential_cutoff = 0;
+  s21::set<int> copy(source, options);
+  EXPECT_TRUE(copy.is_balanced());
+  EXPECT_TRUE(std::equal(copy.cbegin(), copy.cend(), source.cbegin(),
+                         source.cend()));
+}
+
+// ключ, копирование которого можно заставить бросить
+struct fragile_key {
+  static inline std::atomic<int> live{0};
+  static inline std::atomic<int> copies_left{-1};
+  int value;
+  explicit fragile_key(int key) : value(key) { ++live; }
+  fragile_key(const fragile_key& other) : value(other.value) {
+    if (copies_left.fetch_sub(1) == 0) throw std::runtime_error("copy");
+    ++live;
+  }
+  ~fragile_key() { --live; }
+  bool operator<(const fragile_key& other) const {
+    return value < other.value;
+  }
+};
+
+TEST(set_test, parallel_copy_failure_destroys_copied_keys) {
+  {
+    s21::set<fragile_key> source;
+    for (int i = 0; i < 3000; ++i) source.emplace(i);
+    ASSERT_EQ(fragile_key::live, 3000);
+    s21::parallel_options options;
+    options.threads = 8;
+    options.sequential_cutoff = 0;
+    for (int failing_copy : {0, 700, 1900, 2999}) {
+      fragile_key::copies_left = failing_copy;
+      EXPECT_THROW(s21::set<fragile_key> copy(source, options),
+                   std::runtime_error);
+      EXPECT_EQ(fragile_key::live, 3000);
+    }
+    fragile_key::copies_left = -1000000;
+  }
+  EXPECT_EQ(fragile_key::live, 0);
+}
+
+TEST(set_test, arithmetic_keys_in_both_orders) {
+  s21::set<int, std::greater<int>> s21_desc;
+  std::set<int, std::greater<int>> std_desc;
+  s21::set<double> s21_real;
+  std::set<double> std_real;
+  for (int i = 0; i < 3000; ++i) {
+    int key = (i * 7919) % 2000;
+    EXPECT_EQ(s21_desc.insert(key).second, std_desc.insert(key).second);
+    EXPECT_EQ(s21_real.insert(key * 0.5).second,
+              std_real.insert(key * 0.5).second);
+  }
+  EXPECT_TRUE(std::equal(s21_desc.cbegin(), s21_desc.cend(),
+                         std_desc.cbegin(), std_desc.cend()));
+  for (int key = -5; key < 2005; key += 3) {
+    EXPECT_EQ(s21_desc.contains(key), std_desc.count(key) == 1);
+    auto lower = s21_desc.lower_bound(key);
+    EXPECT_EQ(lower == s21_desc.end(),
+              std_desc.lower_bound(key) == std_desc.end());
+    if (lower != s21_desc.end()) {
+      EXPECT_EQ(*lower, *std_desc.lower_bound(key));
+    }
+    auto upper = s21_real.upper_bound(key * 0.25);
+    EXPECT_EQ(upper == s21_real.end(),
+              std_real.upper_bound(key * 0.25) == std_real.end());
+    if (upper != s21_real.end()) {
+      EXPECT_EQ(*upper, *std_real.upper_bound(key * 0.25));
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../s21_library/s21_unordered_map.h"
+
+TEST(unordered_map_test, matches_std_unordered_map) {
+  s21::unordered_map<int, std::string> s21_map;
+  std::unordered_map<int, std::string> std_map;
+  for (int i = 0; i < 5000; ++i) {
+    int key = i * 7919 % 1777;
+    s21_map[key] += "x";
+    std_map[key] += "x";
+    if (i % 3 == 0) {
+      EXPECT_EQ(s21_map.erase(i % 1777), std_map.erase(i % 1777));
+    }
+  }
+  EXPECT_EQ(s21_map.size(), std_map.size());
+  size_t visited = 0;
+  for (const auto& item : s21_map) {
+    EXPECT_EQ(std_map.at(item.first), item.second);
+    ++visited;
+  }
+  EXPECT_EQ(visited, std_map.size());
+  EXPECT_LE(s21_map.load_factor(), 0.875f);
+}
+
+TEST(unordered_map_test, insert_at_and_assign) {
+  s21::unordered_map<std::string, int> s21_map{{"one", 1}, {"two", 2}};
+  EXPECT_FALSE(s21_map.insert({"one", 10}).second);
+  EXPECT_TRUE(s21_map.insert("three", 3).second);
+  EXPECT_FALSE(s21_map.insert_or_assign("one", 11).second);
+  EXPECT_TRUE(s21_map.insert_or_assign("four", 4).second);
+  EXPECT_EQ(s21_map.at("one"), 11);
+  EXPECT_EQ(s21_map.at("four"), 4);
+  EXPECT_THROW(s21_map.at("five"), std::out_of_range);
+  EXPECT_TRUE(s21_map.contains("three"));
+  EXPECT_FALSE(s21_map.contains("five"));
+  const auto copy = s21_map;
+  EXPECT_EQ(copy.at("two"), 2);
+  EXPECT_EQ(copy.size(), 4U);
+}
+
+TEST(unordered_map_test, insert_many_reserve_and_rehash) {
+  s21::unordered_map<int, int> s21_map;
+  s21_map.reserve(1000);
+  size_t buckets = s21_map.bucket_count();
+  for (int i = 0; i < 1000; ++i) s21_map[i] = i * i;
+  EXPECT_EQ(s21_map.bucket_count(), buckets);
+  auto results = s21_map.insert_many(std::pair<int, int>{5, 0},
+                                     std::pair<int, int>{2000, 1});
+  EXPECT_FALSE(results[0].second);
+  EXPECT_EQ(results[0].first->second, 25);
+  EXPECT_TRUE(results[1].second);
+  EXPECT_EQ(results[1].first->first, 2000);
+  s21_map.rehash(1 << 14);
+  EXPECT_EQ(s21_map.bucket_count(), 1U << 14);
+  EXPECT_EQ(s21_map.at(999), 999 * 999);
+  s21_map.clear();
+  EXPECT_TRUE(s21_map.empty());
+  EXPECT_EQ(s21_map.begin(), s21_map.end());
+}
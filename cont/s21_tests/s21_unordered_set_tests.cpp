@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../s21_library/s21_unordered_set.h"
+
+TEST(unordered_set_test, insert_contains_erase) {
+  s21::unordered_set<std::string> s21_set;
+  std::unordered_set<std::string> std_set;
+  for (int i = 0; i < 3000; ++i) {
+    std::string key = std::to_string(i * 31 % 997);
+    EXPECT_EQ(s21_set.insert(key).second, std_set.insert(key).second);
+    if (i % 4 == 0) {
+      std::string gone = std::to_string(i % 997);
+      EXPECT_EQ(s21_set.erase(gone), std_set.erase(gone));
+    }
+  }
+  EXPECT_EQ(s21_set.size(), std_set.size());
+  for (const auto& key : std_set) {
+    EXPECT_TRUE(s21_set.contains(key));
+  }
+  EXPECT_FALSE(s21_set.contains("-1"));
+}
+
+TEST(unordered_set_test, insert_many_and_move) {
+  s21::unordered_set<int> s21_set{1, 2, 3};
+  auto results = s21_set.insert_many(3, 4, 4);
+  ASSERT_EQ(results.size(), 3U);
+  EXPECT_FALSE(results[0].second);
+  EXPECT_TRUE(results[1].second);
+  EXPECT_FALSE(results[2].second);
+  EXPECT_EQ(*results[2].first, 4);
+  s21::unordered_set<int> moved(std::move(s21_set));
+  EXPECT_EQ(moved.size(), 4U);
+  EXPECT_TRUE(s21_set.empty());
+  s21_set = std::move(moved);
+  EXPECT_TRUE(s21_set.contains(4));
+}